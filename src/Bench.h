@@ -0,0 +1,13 @@
+#pragma once
+
+constexpr int default_bench_depth = 7;
+constexpr int default_bench_hash_mb = 16;
+
+/*
+	Searches a fixed set of positions to a fixed depth, each one with a new transposition table and search context,
+	and prints the total number of nodes, time and nodes per second. With a single thread the total number of nodes
+	only changes when the search changes, so it works as a signature of the search to check that a change which should
+	only make the engine faster didn't change the search. With more threads the number of nodes is not deterministic.
+	Threads and hash size are clamped to the same ranges as the UCI options.
+*/
+void bench(int depth = default_bench_depth, int num_threads = 1, int hash_size_mb = default_bench_hash_mb);
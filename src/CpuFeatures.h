@@ -0,0 +1,84 @@
+#pragma once
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+// Instruction sets supported by the CPU (and enabled by the OS) running the engine, used to pick SIMD kernels at runtime
+struct CpuFeatures {
+	bool sse41		= false;
+	bool avx2		= false;
+	bool avx512bw	= false; // Also requires AVX-512F and AVX-512VL
+	bool avx512vnni = false;
+	bool bmi2		= false;
+};
+
+inline void cpuid(int leaf, int subleaf, uint32_t regs[4]) {
+#if defined(_MSC_VER)
+	int r[4];
+	__cpuidex(r, leaf, subleaf);
+	for (int i = 0; i < 4; i++) regs[i] = r[i];
+#elif defined(__x86_64__) || defined(__i386__)
+	__cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#else
+	regs[0] = regs[1] = regs[2] = regs[3] = 0;
+#endif
+}
+
+// Register states enabled by the OS (XCR0)
+inline uint64_t xgetbv() {
+#if defined(_MSC_VER)
+	return _xgetbv(0);
+#elif defined(__x86_64__) || defined(__i386__)
+	uint32_t eax, edx;
+	__asm__ volatile ("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+	return (uint64_t(edx) << 32) | eax;
+#else
+	return 0;
+#endif
+}
+
+inline CpuFeatures detectCpuFeatures() {
+	CpuFeatures features;
+	uint32_t regs[4];
+
+	cpuid(0, 0, regs);
+	uint32_t max_leaf = regs[0];
+	if (max_leaf < 1) return features;
+
+	cpuid(1, 0, regs);
+	features.sse41 = regs[2] & (1u << 19);
+
+	bool osxsave = regs[2] & (1u << 27);
+	if (max_leaf < 7) return features;
+
+	cpuid(7, 0, regs);
+	features.bmi2 = regs[1] & (1u << 8); // General purpose registers only, no OS support needed
+
+	if (!osxsave) return features;
+
+	uint64_t xcr0 = xgetbv();
+	bool os_avx	   = (xcr0 & 0x06) == 0x06; // XMM and YMM registers
+	bool os_avx512 = (xcr0 & 0xe6) == 0xe6; // and opmask and ZMM registers
+
+	bool avx2		 = regs[1] & (1u << 5);
+	bool avx512f	 = regs[1] & (1u << 16);
+	bool avx512bw	 = regs[1] & (1u << 30);
+	bool avx512vl	 = regs[1] & (1u << 31);
+	bool avx512vnni	 = regs[2] & (1u << 11);
+
+	features.avx2		= os_avx && avx2;
+	features.avx512bw	= os_avx512 && features.avx2 && avx512f && avx512bw && avx512vl;
+	features.avx512vnni = features.avx512bw && avx512vnni;
+
+	return features;
+}
+
+// Detected once, the first time it is needed
+inline const CpuFeatures& cpuFeatures() {
+	static const CpuFeatures features = detectCpuFeatures();
+	return features;
+}
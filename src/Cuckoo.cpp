@@ -0,0 +1,54 @@
+#include "Cuckoo.h"
+#include "MagicBitboards.h"
+#include "Zobrist.h"
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+
+// Number of reversible moves of the pieces of both colors in an empty board
+constexpr int num_cuckoo_moves = 3668;
+
+CuckooTables::CuckooTables(const ZobristKeys& zobrist_keys) {
+	int num_moves = 0;
+
+	auto add_moves = [&](const std::array<uint64_t, 64>& piece_keys, auto attacks) {
+		for (int start_square = 0; start_square < 64; start_square++) {
+			for (int final_square = start_square + 1; final_square < 64; final_square++) {
+				if (!attacks(start_square, final_square)) continue;
+
+				uint64_t key = piece_keys[start_square] ^ piece_keys[final_square] ^ zobrist_keys.is_black_to_move;
+				unsigned short move = (start_square << 6) | final_square;
+
+				// Moves the key already in the slot to its other slot until one of them is empty
+				int i = h1(key);
+				while (true) {
+					std::swap(keys[i], key);
+					std::swap(moves[i], move);
+					if (move == 0) break;
+					i = (i == h1(key)) ? h2(key) : h1(key);
+				}
+				num_moves++;
+			}
+		}
+	};
+
+	auto knight = [](int start, int final) { return (magic_bitboards.knights_attacks_array[start] >> final) & 1; };
+	auto king	= [](int start, int final) { return (magic_bitboards.king_attacks_array[start] >> final) & 1; };
+	auto bishop = [](int start, int final) { return magic_bitboards.bishop_squares_uncheck[start][final] != 0; };
+	auto rook	= [](int start, int final) { return magic_bitboards.rook_squares_uncheck[start][final] != 0; };
+	auto queen	= [&](int start, int final) { return bishop(start, final) || rook(start, final); };
+
+	add_moves(zobrist_keys.white_knight, knight);
+	add_moves(zobrist_keys.white_bishop, bishop);
+	add_moves(zobrist_keys.white_rook, rook);
+	add_moves(zobrist_keys.white_queen, queen);
+	add_moves(zobrist_keys.white_king, king);
+	add_moves(zobrist_keys.black_knight, knight);
+	add_moves(zobrist_keys.black_bishop, bishop);
+	add_moves(zobrist_keys.black_rook, rook);
+	add_moves(zobrist_keys.black_queen, queen);
+	add_moves(zobrist_keys.black_king, king);
+
+	assert(num_moves == num_cuckoo_moves, "Wrong number of reversible moves in the cuckoo tables.");
+}
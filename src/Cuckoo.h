@@ -0,0 +1,30 @@
+#pragma once
+#include "Zobrist.h"
+#include <array>
+#include <cstdint>
+
+constexpr int cuckoo_size = 8192;
+
+/*
+	Zobrist keys of every reversible move of a knight, bishop, rook, queen or king (the keys of the piece in both squares
+	and of the side to move), in cuckoo tables (Marcel van Kervinck's method). If the hashes of two positions differ by
+	one of these keys, they are one move apart, which is checked with only two lookups.
+*/
+struct CuckooTables {
+	std::array<uint64_t, cuckoo_size> keys = {};
+	std::array<unsigned short, cuckoo_size> moves = {}; // Only the start and final squares, as in an encoded move
+
+	CuckooTables(const ZobristKeys& zobrist_keys);
+
+	static inline int h1(uint64_t key) { return key & (cuckoo_size - 1); }
+	static inline int h2(uint64_t key) { return (key >> 16) & (cuckoo_size - 1); }
+
+	// Returns the move with the key, or 0 if the key is not of a reversible move
+	inline unsigned short find(uint64_t move_key) const {
+		if (keys[h1(move_key)] == move_key) return moves[h1(move_key)];
+		if (keys[h2(move_key)] == move_key) return moves[h2(move_key)];
+		return 0;
+	}
+};
+
+inline CuckooTables cuckoo_tables = CuckooTables(zobrist_keys); // Initialized after the global Zobrist Keys it is built from
@@ -0,0 +1,68 @@
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+/*
+	Generates a source file with the contents of a file and a function returning them, used to embed data files in the binary.
+	Usage: EmbedFile <input file> <output source> <function name>
+
+	Large arrays of integers take minutes to compile with GCC, so the data is written as a string literal, except on
+	MSVC, which limits the size of string literals, where it is written as an array of 64 bit (little endian) words.
+*/
+int main(int argc, char* argv[]) {
+	if (argc != 4) {
+		std::cerr << "Usage: EmbedFile <input file> <output source> <function name>\n";
+		return 1;
+	}
+
+	std::ifstream in_file(argv[1], std::ios::binary);
+	if (!in_file) {
+		std::cerr << "Could not open " << argv[1] << '\n';
+		return 2;
+	}
+
+	std::vector<uint8_t> data((std::istreambuf_iterator<char>(in_file)), std::istreambuf_iterator<char>());
+	const std::string function_name = argv[3];
+	const std::string array_name = function_name + "_data";
+
+	std::ofstream out_file(argv[2]);
+	if (!out_file) {
+		std::cerr << "Could not create " << argv[2] << '\n';
+		return 3;
+	}
+
+	out_file << "// Generated by EmbedFile from " << argv[1] << ", do not edit\n";
+	out_file << "#include \"EmbeddedData.h\"\n#include <cstdint>\n#include <span>\n\n";
+
+	out_file << "#ifdef _MSC_VER\n";
+	out_file << "alignas(64) static const uint64_t " << array_name << "[] = {\n";
+	for (size_t i = 0; i < data.size(); i += 8) {
+		uint64_t word = 0;
+		for (size_t j = 0; j < 8 && i + j < data.size(); j++) word |= (uint64_t) data[i + j] << (8 * j);
+
+		out_file << "0x" << std::hex << word << std::dec << ((i / 8) % 16 == 15 ? ",\n" : ",");
+	}
+	if (data.empty()) out_file << "0";
+	out_file << "\n};\n";
+
+	out_file << "#else\n";
+	out_file << "alignas(64) static const char " << array_name << "[] =\n";
+	for (size_t i = 0; i < data.size(); i += 64) {
+		out_file << '"';
+		for (size_t j = i; j < i + 64 && j < data.size(); j++) out_file << '\\' << std::oct << (int) data[j] << std::dec;
+		out_file << "\"\n";
+	}
+	if (data.empty()) out_file << "\"\"\n";
+	out_file << ";\n";
+	out_file << "#endif\n\n";
+
+	out_file << "std::span<const uint8_t> " << function_name << "() {\n";
+	out_file << "\treturn { reinterpret_cast<const uint8_t*>(" << array_name << "), " << data.size() << " };\n";
+	out_file << "}\n";
+
+	return 0;
+}
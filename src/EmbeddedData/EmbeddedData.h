@@ -0,0 +1,13 @@
+#pragma once
+#include <cstdint>
+#include <span>
+
+/*
+	Data files compiled into the binary with EMBED_DATA (CMake option), so it does not depend on any file at runtime
+	(magic bitboards are always generated at compile time).
+	The data is used in place (read only), without copies. Without EMBED_DATA the spans are empty and the files are
+	loaded at runtime.
+*/
+
+// Network file, see NetworkFile.h
+std::span<const uint8_t> embeddedNetwork();
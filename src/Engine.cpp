@@ -1,10 +1,12 @@
 #include "Engine.h"
+#include "CpuFeatures.h"
 #include "GameOutcomes.h"
 #include "MagicBitboards.h"
 #include "MakeMoves.h"
 #include "Moves.h"
 #include "Position.h"
 #include "Search.h"
+#include "SearchStats.h"
 #include "TranspositionTable.h"
 #include "Zobrist.h"
 #include "EvaluateNNUE.h"
@@ -12,11 +14,14 @@
 #include <thread>
 
 Engine::Engine() {
-	tt = TranspositionTable(tt_size_mb);
-	bool nnue_loaded = nnue.is_loaded();
-	bool magic_bitboards_loaded = magic_bitboards.loadMagicBitboards();
+	loaded = network_weights.loaded;
 
-	loaded = nnue_loaded && magic_bitboards_loaded;
+#ifdef USE_PEXT
+	if (!cpuFeatures().bmi2) {
+		std::cout << "Engine was built with USE_PEXT, which requires a CPU with BMI2.\n";
+		loaded = false;
+	}
+#endif
 }
 
 bool Engine::didLoad() const {
@@ -53,14 +58,20 @@ void Engine::MakeMove(unsigned short move) {
 void Engine::search(bool print_best_move) {
 	if (searcher.joinable()) searcher.join();
 
-	search_id++;
+	// Info lines only in UCI mode, same as the best move
+	search_context.print_info = print_best_move;
+
 	searcher = std::thread([&, print_best_move]() {
 		if (infinite_search)
-			FindBestMoveItrDeepening(9999, *player, *opponent, hash_positions, position.half_moves, search_result);
+			FindBestMoveItrDeepening(search_context, 9999, *player, *opponent, hash_positions, position.half_moves, search_result);
 		else if (fixed_depth > 0)
-			FindBestMoveItrDeepening(fixed_depth, *player, *opponent, hash_positions, position.half_moves, search_result);
+			FindBestMoveItrDeepening(search_context, fixed_depth, *player, *opponent, hash_positions, position.half_moves, search_result);
 		else
-			FindBestMoveItrDeepening(search_time, *player, *opponent, hash_positions, position.half_moves, search_result);
+			FindBestMoveItrDeepening(search_context, search_time, *player, *opponent, hash_positions, position.half_moves, search_result);
+
+		if constexpr (search_stats_enabled) {
+			if (print_best_move) std::cout << "info string stats " << searchStatsToJson(search_context.threadStats()) << '\n';
+		}
 
 		if (print_best_move) {
 			std::cout << "bestmove " << moveToStr(search_result.best_move);
@@ -70,8 +81,37 @@ void Engine::search(bool print_best_move) {
 	});
 }
 
-void Engine::stop() const {
-	stopSearch(search_id);
+bool Engine::setHashSize(int size_mb) {
+	if (searcher.joinable()) searcher.join();
+
+	bool resized = tt.resize(std::clamp(size_mb, 1, max_tt_size_mb));
+	tt.setRoot(player->bitboards.all_pieces);
+	return resized;
+}
+
+void Engine::clearHash() {
+	if (searcher.joinable()) searcher.join();
+
+	tt.clear(search_context.num_threads);
+	tt.setRoot(player->bitboards.all_pieces);
+}
+
+bool Engine::saveHash(const std::filesystem::path& path) {
+	if (searcher.joinable()) searcher.join();
+
+	return tt.save(path);
+}
+
+bool Engine::loadHash(const std::filesystem::path& path) {
+	if (searcher.joinable()) searcher.join();
+
+	bool loaded = tt.load(path);
+	tt.setRoot(player->bitboards.all_pieces);
+	return loaded;
+}
+
+void Engine::stop() {
+	search_context.stop = true;
 }
 
 SearchResult Engine::waitSearchResult() {
@@ -2,14 +2,20 @@
 #include "GameOutcomes.h"
 #include "Position.h"
 #include "Search.h"
+#include "SearchContext.h"
+#include "TranspositionTable.h"
+#include <algorithm>
 #include <chrono>
+#include <filesystem>
 #include <thread>
 
-constexpr size_t tt_size_mb = 256; // must be a power of two
+constexpr int default_tt_size_mb = 256;
 
 class Engine {
 	bool loaded = false;
-	int search_id = 0;
+
+	TranspositionTable tt = TranspositionTable(default_tt_size_mb);
+	SearchContext search_context = SearchContext(tt);
 
 	unsigned long long hash;
 	Position position;
@@ -36,7 +42,7 @@ public:
 	void MakeMove(unsigned short move);
 
 	void search(bool print_best_move=true);
-	void stop() const;
+	void stop();
 
 	SearchResult waitSearchResult();
 	
@@ -48,4 +54,15 @@ public:
 	void setDepth(int depth) { fixed_depth = depth; infinite_search = false; }
 	void setSearchTime(int search_time) { this->search_time = std::chrono::milliseconds(search_time); infinite_search = false; }
 	void setInfiniteSearch() { infinite_search = true; fixed_depth = 0; }
+
+	void setThreads(int num_threads) { search_context.num_threads = std::clamp(num_threads, 1, max_threads); }
+
+	// Both wait for the current search to finish, setHashSize returns false if the memory couldn't be allocated (see TranspositionTable::resize)
+	bool setHashSize(int size_mb);
+	int hashSizeMB() const { return (int) tt.sizeMB(); }
+	void clearHash();
+
+	// Snapshot of the transposition table (see TranspositionTable::save), both return false if it failed
+	bool saveHash(const std::filesystem::path& path);
+	bool loadHash(const std::filesystem::path& path);
 };
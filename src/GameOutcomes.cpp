@@ -1,15 +1,17 @@
 #include "GameOutcomes.h"
+#include "Cuckoo.h"
+#include "MagicBitboards.h"
 #include "MakeMoves.h"
 #include "Moves.h"
 #include "Player.h"
-#include <vector>
+#include <algorithm>
+#include <cassert>
 
 constexpr unsigned long long white_squares = 0x55AA55AA55AA55AA;
 constexpr unsigned long long black_squares = ~white_squares;
 
 HashPositions::HashPositions(unsigned long long initial_hash) {
-	positions.reserve(100);
-	positions.push_back(initial_hash);
+	positions[size++] = initial_hash;
 }
 
 int HashPositions::updatePositions(const short capture_flag, const unsigned short move_flag, const unsigned long long new_hash, int half_moves) {
@@ -25,24 +27,13 @@ int HashPositions::updatePositions(const short capture_flag, const unsigned shor
 		clear();
 	}
 
-	positions.push_back(new_hash);
+	assert(size < max_hash_positions, "Game and search line are longer than max_hash_positions.");
+	positions[size++] = new_hash;
 
 	return half_moves;
 }
 
-void HashPositions::unbranch(int previous_branch_id, int previous_start) {
-	clear();
-	branch_id = previous_branch_id;
-	start = previous_start;
-}
-
-void HashPositions::clear() {
-	int size = positions.size(); 
-	for (int i = branch_id; i < size; i++) positions.pop_back(); 
-	start = branch_id;
-}
-
-GameOutcome getGameOutcome(const Player& player, const Player& opponent, const HashPositions& positions, int half_moves) {
+GameOutcome getGameOutcome(const Player& player, const Player& opponent, const HashPositions& positions, int half_moves, bool check_material) {
 	if (half_moves == 100) {
 		return draw_by_50_move_rule;
 	}
@@ -55,10 +46,11 @@ GameOutcome getGameOutcome(const Player& player, const Player& opponent, const H
 		unsigned long long repeated_pos = positions.lastHash();
 		int count = 1;
 
-		// A position can only repeat after at leat two moves for each side
+		// A position can only repeat after at leat two moves for each side, and not before the last capture or pawn move
 		int i = positions.numPositions() - 5;
+		int first = std::max(0, positions.numPositions() - 1 - half_moves);
 
-		while (i >= 0) {
+		while (i >= first) {
 			if (positions[i] == repeated_pos) {
 				if (++count == 3) {
 					return draw_by_repetition;
@@ -72,6 +64,8 @@ GameOutcome getGameOutcome(const Player& player, const Player& opponent, const H
 		}
 	}
 
+	if (!check_material) return ongoing;
+
 	// Draws by insufficient material
 	const Player* player_with_only_king = nullptr;
 	const Player* other_player = nullptr;
@@ -108,3 +102,36 @@ GameOutcome getGameOutcome(const Player& player, const Player& opponent, const H
 
 	return ongoing;
 }
+
+bool hasUpcomingRepetition(const Player& player, const HashPositions& positions, int half_moves, int ply) {
+	int last = positions.numPositions() - 1;
+	int end = std::min(half_moves, last);
+	if (end < 3) return false;
+
+	unsigned long long current_hash = positions.lastHash();
+
+	// The player needs at least two moves (and the opponent one) to come back to a position with the same player to move
+	for (int i = 3; i <= end; i += 2) {
+		unsigned short move = cuckoo_tables.find(current_hash ^ positions[last - i]);
+		if (move == 0) continue;
+
+		location start_square = getStartSquare(move);
+		location final_square = getFinalSquare(move);
+
+		// Squares between start and final squares must be empty (0 for knight and king moves)
+		unsigned long long between = magic_bitboards.bishop_squares_uncheck[start_square][final_square] |
+									 magic_bitboards.rook_squares_uncheck[start_square][final_square];
+		if (between & ~(1ULL << start_square) & player.bitboards.all_pieces) continue;
+
+		if (i < ply) return true;
+
+		// Before the root the piece must be the player's and the position must have been repeated (i + 4 or more plies back)
+		unsigned long long piece_squares = (1ULL << start_square) | (1ULL << final_square);
+		if (!(piece_squares & player.bitboards.friendly_pieces)) continue;
+
+		for (int j = i + 4; j <= end; j += 2)
+			if (positions[last - j] == positions[last - i]) return true;
+	}
+
+	return false;
+}
@@ -1,13 +1,21 @@
 #pragma once
 #include "Player.h"
 #include <algorithm>
-#include <vector>
+#include <array>
 
 enum GameOutcome { ongoing, checkmate, stalemate, draw_by_insufficient_material, draw_by_repetition, draw_by_50_move_rule };
 
+// Positions since the last irreversible move of the game (at most 100 by the 50 move rule) and the plies of the search
+constexpr int max_hash_positions = 1024;
+
+/*
+	Hashes of the positions of the game and of the current line of the search, used to find repetitions. It is a stack
+	in a fixed array, so that making and unmaking moves in the search doesn't allocate or free memory.
+*/
 struct HashPositions {
 private:
-	std::vector<unsigned long long> positions;
+	std::array<unsigned long long, max_hash_positions> positions;
+	int size = 0;
 
 public:
 	int branch_id = 0, start = 0;
@@ -15,26 +23,40 @@ public:
 	HashPositions() = default;
 	HashPositions(unsigned long long initial_hash);
 
-	// Updates positions vector and returns new number of half moves
+	// Updates positions and returns new number of half moves
 	int updatePositions(const short capture_flag, const unsigned short move_flag, const unsigned long long new_hash, int half_moves);
 
 	/* 
 	Call branch every time going to a new search, 
-	will protected every element in the vector before 
+	will protected every element in the stack before 
 	the branching from being deleted.
 	*/ 
-	inline void branch() { branch_id = positions.size(); }
-	void unbranch(int previous_branch_id, int previous_start);
+	inline void branch() { branch_id = size; }
+	inline void unbranch(int previous_branch_id, int previous_start) { size = branch_id; branch_id = previous_branch_id; start = previous_start; }
 
-	inline int numPositions() const { return positions.size() - start; }
-	inline unsigned long long lastHash() const { return positions.back(); }
+	inline int numPositions() const { return size - start; }
+	inline unsigned long long lastHash() const { return positions[size - 1]; }
 
 	inline unsigned long long operator[] (int i) const { return positions[i + start]; }
 	inline unsigned long long& operator[] (int i) { return positions[i + start]; }
 
-	inline bool contains(unsigned long long hash) const { return std::find(positions.begin(), positions.end(), hash) != positions.end(); }
+	inline bool contains(unsigned long long hash) const { return std::find(positions.begin(), positions.begin() + size, hash) != positions.begin() + size; }
+
+	inline void clear() { size = start = branch_id; }
 
-	void clear();
+	// Positions before a null move can't be repeated after it (a null move isn't a legal move), so it starts a new window
+	inline void addNullMove(unsigned long long new_hash) { clear(); positions[size++] = new_hash; }
 };
 
-GameOutcome getGameOutcome(const Player& player, const Player& opponent, const HashPositions& positions, int half_moves);
+/*
+	Material only changes with captures, so the search checks for insufficient material only after them (check_material)
+	instead of at every node.
+*/
+GameOutcome getGameOutcome(const Player& player, const Player& opponent, const HashPositions& positions, int half_moves, bool check_material = true);
+
+/*
+	True if the player can move a piece back to repeat a position, which gives the player at least a draw. A position of
+	the game (more than ply plies back, before the root of the search) only counts if it was alredy repeated, since then
+	repeating it again ends the game. Uses the cuckoo tables of reversible moves (see Cuckoo.h).
+*/
+bool hasUpcomingRepetition(const Player& player, const HashPositions& positions, int half_moves, int ply);
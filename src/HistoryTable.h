@@ -20,5 +20,3 @@ public:
 	// Records the depth at which the move caused a cutoff.
 	void record(bool is_white, unsigned short move_flag, location final_square, int depth);
 };
-
-inline HistoryTable history_table; // Global history table
@@ -1,8 +1,8 @@
 #include "MagicBitboards.h"
-#include "Moves.h"
-#include "Serializer.h"
-#include <algorithm>
+#include "Locations.h"
+#include "MagicNumbers.h"
 #include <array>
+#include <bit>
 
 constexpr std::array<short, 8> knight_moves_offsets = { -17, -15, -10, -6, 6, 10, 15, 17 };
 constexpr std::array<short, 8> knight_moves_offsets_a_file = { -15, -6, 10, 17 };
@@ -14,21 +14,99 @@ constexpr std::array<short, 8> king_moves_offsets = { -9, -8, -7, -1, 1, 7, 8, 9
 constexpr std::array<short, 8> king_moves_offsets_right_edge = { -9, -8, -1, 7, 8 };
 constexpr std::array<short, 8> king_moves_offsets_left_edge = { -8, -7, 1, 8, 9 };
 
-bool MagicBitboards::loadMagicBitboards() {
+// Attacks of a sliding piece on square with the given blockers, squares of the first blocker in each direction are attacked
+constexpr unsigned long long slidingAttacks(int square, unsigned long long blockers, bool is_bishop) {
+	constexpr int directions_bishop[4][2] = { { 1, 1 }, { 1, -1 }, { -1, 1 }, { -1, -1 } };
+	constexpr int directions_rook[4][2]   = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } };
 
-	// Load pre compted magic numbers for sliding pieces
-	SaveFile save_file = loadMagics();
-	if (save_file.attacks_array.size() == 0) return false;
+	unsigned long long attacks = 0;
+	for (const auto& [offset_file, offset_rank] : (is_bishop ? directions_bishop : directions_rook)) {
+		int file = square % 8 + offset_file;
+		int rank = square / 8 + offset_rank;
 
-	this->sliding_attacks_array = save_file.attacks_array;
+		while (file >= 0 && file <= 7 && rank >= 0 && rank <= 7) {
+			unsigned long long square_bitboard = 1ULL << (rank * 8 + file);
+			attacks |= square_bitboard;
 
-	std::transform(save_file.squares_bishops.begin(), save_file.squares_bishops.end(), this->bishops_magic_bitboards.begin(), [&](Square& square) {
-		return MagicBitboard(square.mask, square.magic.magic_number, 64 - square.magic.bits_used, &this->sliding_attacks_array[square.index_attack_array]);
-	});
+			// Stop when a blocker is hit
+			if (blockers & square_bitboard) break;
 
-	std::transform(save_file.squares_rooks.begin(), save_file.squares_rooks.end(), this->rooks_magic_bitboards.begin(), [&](Square& square) {
-		return MagicBitboard(square.mask, square.magic.magic_number, 64 - square.magic.bits_used, &this->sliding_attacks_array[square.index_attack_array]);
-	});
+			file += offset_file;
+			rank += offset_rank;
+		}
+	}
+
+	return attacks;
+}
+
+#ifdef USE_PEXT
+/*
+	With pext the index is the blockers on the relevant squares packed into the low bits, so the attacks of each square take
+	exactly 2^(number of relevant squares) entries, one square after the other (rooks first, then bishops).
+*/
+constexpr std::array<int, 129> generatePextOffsets() {
+	std::array<int, 129> offsets = {};
+	for (int i = 0; i < 128; i++) {
+		const SquareMagic& magic = (i < 64) ? rooks_magics[i] : bishops_magics[i - 64];
+		offsets[i + 1] = offsets[i] + (1 << std::popcount(~magic.mask));
+	}
+	return offsets;
+}
+
+constexpr std::array<int, 129> pext_offsets = generatePextOffsets();
+constexpr int attacks_array_size = pext_offsets[128];
+
+constexpr int attacksOffset(int square, bool is_bishop) { return pext_offsets[square + (is_bishop ? 64 : 0)]; }
+#else
+// Arrays of different squares overlap where they only have unused entries, see GenerateMagicBitboards
+constexpr int attacks_array_size = sliding_attacks_array_size;
+
+constexpr int attacksOffset(int square, bool is_bishop) { return (is_bishop ? bishops_magics : rooks_magics)[square].index_attack_array; }
+#endif
+
+// Attacks of the sliding pieces for every square and arrangement of blockers, indexed by the magic bitboards (or pext)
+constexpr std::array<unsigned long long, attacks_array_size> generateSlidingAttacks() {
+	std::array<unsigned long long, attacks_array_size> attacks_array = {};
+
+	for (bool is_bishop : { false, true }) {
+		for (int square = 0; square < 64; square++) {
+			const SquareMagic& magic = is_bishop ? bishops_magics[square] : rooks_magics[square];
+			const unsigned long long relevant_squares = ~magic.mask;
+
+			// Go through every subset of the relevant squares (Carry-Rippler)
+			unsigned long long blockers = 0;
+#ifdef USE_PEXT
+			int subset_number = 0;
+#endif
+			do {
+#ifdef USE_PEXT
+				// Subsets are visited in the order of their packed bits, so the pext index is just the number of the subset
+				int index = subset_number++;
+#else
+				int index = ((blockers | magic.mask) * magic.magic_number) >> (64 - magic.bits_used);
+#endif
+				attacks_array[attacksOffset(square, is_bishop) + index] = slidingAttacks(square, blockers, is_bishop);
+
+				blockers = (blockers - relevant_squares) & relevant_squares;
+			} while (blockers != 0);
+		}
+	}
+
+	return attacks_array;
+}
+
+alignas(64) static constexpr std::array<unsigned long long, attacks_array_size> sliding_attacks_array = generateSlidingAttacks();
+
+constexpr MagicBitboards generateMagicBitboards() {
+	MagicBitboards magic_bitboards;
+
+	for (int square = 0; square < 64; square++) {
+		const SquareMagic& bishop = bishops_magics[square];
+		const SquareMagic& rook = rooks_magics[square];
+
+		magic_bitboards.bishops_magic_bitboards[square] = { bishop.mask, bishop.magic_number, 64 - bishop.bits_used, &sliding_attacks_array[attacksOffset(square, true)] };
+		magic_bitboards.rooks_magic_bitboards[square] = { rook.mask, rook.magic_number, 64 - rook.bits_used, &sliding_attacks_array[attacksOffset(square, false)] };
+	}
 
 	// Pre compute knight moves
 	for (int start_square = 0; start_square < 64; start_square++) {
@@ -59,8 +137,8 @@ bool MagicBitboards::loadMagicBitboards() {
 		for (short offset : *offsets) {
 			location final_square = start_square + offset;
 			if (final_square >= 0 && final_square <= 63 && offset != 0) {
-				this->knights_attacks_array[start_square] |= (1LL << (final_square));
-				this->knight_moves[start_square].push_back((start_square << 6) | final_square);
+				magic_bitboards.knights_attacks_array[start_square] |= (1LL << (final_square));
+				magic_bitboards.knight_moves[start_square].push_back((start_square << 6) | final_square);
 			}
 		}
 	}
@@ -82,22 +160,23 @@ bool MagicBitboards::loadMagicBitboards() {
 		for (short offset : *offsets) {
 			location final_square = start_square + offset;
 			if (final_square >= 0 && final_square <= 63 && offset != 0) {
-				this->king_attacks_array[start_square] |= (1LL << (final_square));
-				this->king_moves[start_square].push_back((start_square << 6) | final_square);
+				magic_bitboards.king_attacks_array[start_square] |= (1LL << (final_square));
+				magic_bitboards.king_moves[start_square].push_back((start_square << 6) | final_square);
 			}
 		}
 	}
 
 	// Pre compute squares to uncheck
+	auto& bishop_squares_uncheck = magic_bitboards.bishop_squares_uncheck;
+	auto& rook_squares_uncheck = magic_bitboards.rook_squares_uncheck;
+
 	for (int square_piece = 0; square_piece < 64; square_piece++) {
 		for (int square_king = 0; square_king < 64; square_king++) {
 
 			unsigned long long bit_board_king = (1LL << square_king);
-			int index_bishop = (bishops_magic_bitboards[square_piece].mask * bishops_magic_bitboards[square_piece].magic_number) >> bishops_magic_bitboards[square_piece].num_shifts;
-			int index_rook = (rooks_magic_bitboards[square_piece].mask * rooks_magic_bitboards[square_piece].magic_number) >> rooks_magic_bitboards[square_piece].num_shifts;
 
 			// If king is in check by bishop
-			if (bishops_magic_bitboards[square_piece].ptr_attacks_array[index_bishop] & bit_board_king) {
+			if (slidingAttacks(square_piece, 0, true) & bit_board_king) {
 				int file_king = square_king % 8;
 				int file_bishop = square_piece % 8;
 
@@ -112,7 +191,7 @@ bool MagicBitboards::loadMagicBitboards() {
 			}
 
 			// If king is in check by rook
-			if (rooks_magic_bitboards[square_piece].ptr_attacks_array[index_rook] & bit_board_king) {
+			if (slidingAttacks(square_piece, 0, false) & bit_board_king) {
 				int distance = square_piece - square_king;
 				int offset;
 
@@ -142,5 +221,7 @@ bool MagicBitboards::loadMagicBitboards() {
 		}
 	}
 
-	return true;
+	return magic_bitboards;
 }
+
+extern constexpr MagicBitboards magic_bitboards = generateMagicBitboards();
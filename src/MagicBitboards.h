@@ -1,28 +1,37 @@
 #pragma once
 #include <array>
-#include <vector>
 
+/*
+	Attacks of a sliding piece are at ptr_attacks_array[((blockers | mask) * magic_number) >> num_shifts], or, when built
+	with USE_PEXT (CMake option, requires BMI2), at ptr_attacks_array[pext(blockers, ~mask)].
+*/
 struct MagicBitboard {
 	unsigned long long mask, magic_number;
 	int num_shifts;
-	unsigned long long* ptr_attacks_array;
+	const unsigned long long* ptr_attacks_array;
 };
 
+// Moves of a knight or king from a square (at most 8)
+struct LeaperMoves {
+	std::array<unsigned short, 8> moves = {};
+	int num_moves = 0;
+
+	constexpr void push_back(unsigned short move) { moves[num_moves++] = move; }
+
+	constexpr const unsigned short* begin() const { return moves.data(); }
+	constexpr const unsigned short* end() const { return moves.data() + num_moves; }
+};
+
+// All tables are generated at compile time (see MagicBitboards.cpp), from the magic numbers in MagicNumbers.h
 struct MagicBitboards {
 	std::array<unsigned long long, 64> knights_attacks_array = {};
-	std::array<std::vector<unsigned short>, 64> knight_moves;
+	std::array<LeaperMoves, 64> knight_moves = {};
 	std::array<unsigned long long, 64> king_attacks_array = {};
-	std::array<std::vector<unsigned short>, 64> king_moves;
-	std::array<MagicBitboard, 64> bishops_magic_bitboards;
+	std::array<LeaperMoves, 64> king_moves = {};
+	std::array<MagicBitboard, 64> bishops_magic_bitboards = {};
 	std::array<std::array<unsigned long long, 64>, 64> bishop_squares_uncheck = {};
-	std::array<MagicBitboard, 64> rooks_magic_bitboards;
+	std::array<MagicBitboard, 64> rooks_magic_bitboards = {};
 	std::array<std::array<unsigned long long, 64>, 64> rook_squares_uncheck = {};
-
-	bool loadMagicBitboards();
-
-private:
-	std::vector<unsigned long long> sliding_attacks_array;
-
 };
 
-inline MagicBitboards magic_bitboards; // Global Magic Bitboards
+extern const MagicBitboards magic_bitboards; // Global Magic Bitboards
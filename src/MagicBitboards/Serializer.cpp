@@ -1,71 +1,44 @@
 #include "Serializer.h"
 #include "Square.h"
-#include <algorithm>
 #include <array>
+#include <cstddef>
 #include <filesystem>
 #include <fstream>
-#include <vector>
+#include <ios>
+#include <string>
 
-SaveFile::SaveFile(std::array<Square, 64>& squares_bishops, std::array<Square, 64>& squares_rooks, std::vector<unsigned long long>& attacks_array) {
-	this->squares_bishops = squares_bishops;
-	this->squares_rooks = squares_rooks;
-	this->attacks_array = attacks_array;
-}
-
-SaveFile::SaveFile(SaveFile& other) {
-	this->squares_bishops = other.squares_bishops;
-	this->squares_rooks = other.squares_rooks;
-	this->attacks_array = other.attacks_array;
-}
+static void storeSquares(std::ofstream& file, const std::string& name, const std::array<Square, 64>& squares) {
+	file << "constexpr std::array<SquareMagic, 64> " << name << " = {{\n";
 
-void SaveFile::store(std::ofstream& file) const {
-	file.write((char*) squares_bishops.data(), squares_bishops.size() * sizeof(Square));
-	file.write((char*) squares_rooks.data(), squares_rooks.size() * sizeof(Square));
+	for (const Square& square : squares) {
+		file << "\t{ 0x" << std::hex << square.mask << ", 0x" << square.magic.magic_number << std::dec << ", "
+			 << square.magic.bits_used << ", " << square.index_attack_array << " },\n";
+	}
 
-	size_t attacks_array_size = attacks_array.size();
-	file.write((char*) &attacks_array_size, sizeof(size_t));
-	file.write((char*) attacks_array.data(), attacks_array.size() * sizeof(unsigned long long));
+	file << "}};\n";
 }
 
-void SaveFile::load(std::ifstream& file) {
-	file.read((char*) squares_bishops.data(), squares_bishops.size() * sizeof(Square));
-	file.read((char*) squares_rooks.data(), squares_rooks.size() * sizeof(Square));
-
-	size_t attacks_array_size;
-	file.read((char*) &attacks_array_size, sizeof(size_t));
-	attacks_array.reserve(attacks_array_size);
+bool storeMagics(const std::array<Square, 64>& squares_bishops, const std::array<Square, 64>& squares_rooks, size_t attacks_array_size) {
+	// Header goes in the engine's source directory
+	std::filesystem::path dir_path = std::filesystem::path(__FILE__).parent_path().parent_path();
 
-	for (int i = 0; i < attacks_array_size; i++) {
-		unsigned long long attacks;
-		file.read((char*) &attacks, sizeof(unsigned long long));
-		attacks_array.push_back(attacks);
-	}
-}
+	std::ofstream file(dir_path / "MagicNumbers.h");
+	if (!file) return false;
 
-bool storeMagics(std::array<Square, 64>& squares_bishops, std::array<Square, 64>& squares_rooks, std::vector<unsigned long long>& attacks_array) {
-	SaveFile save_file(squares_bishops, squares_rooks, attacks_array);
+	file << "#pragma once\n";
+	file << "#include <array>\n\n";
+	file << "// Generated by GenerateMagicBitboards (src/MagicBitboards), do not edit\n\n";
 
-	// Get file's directory
-	std::filesystem::path dir_path = std::filesystem::path(__FILE__).parent_path();
+	file << "struct SquareMagic {\n";
+	file << "\tunsigned long long mask, magic_number; // Mask is inverted (black magic bitboards)\n";
+	file << "\tint bits_used, index_attack_array;\n";
+	file << "};\n\n";
 
-	std::ofstream file_out(dir_path / "magic_numbers.bin", std::ios::binary);
-	if (!file_out) return false;
+	file << "constexpr int sliding_attacks_array_size = " << attacks_array_size << ";\n\n";
 
-	save_file.store(file_out);
+	storeSquares(file, "bishops_magics", squares_bishops);
+	file << '\n';
+	storeSquares(file, "rooks_magics", squares_rooks);
 
 	return true;
-} 
-
-SaveFile loadMagics() {
-	SaveFile save_file;
-
-	// Get file's directory
-	std::filesystem::path dir_path = std::filesystem::path(__FILE__).parent_path();
-
-	std::ifstream file_in(dir_path / "magic_numbers.bin", std::ios::binary);
-	if (!file_in.is_open()) return save_file;
-
-	save_file.load(file_in);
-
-	return save_file;
 }
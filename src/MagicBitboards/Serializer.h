@@ -1,21 +1,10 @@
 #pragma once
 #include "Square.h"
 #include <array>
-#include <fstream>
-#include <vector>
+#include <cstddef>
 
-struct SaveFile {
-	std::array<Square, 64> squares_bishops = {};
-	std::array<Square, 64> squares_rooks = {};
-	std::vector<unsigned long long> attacks_array;
-
-	SaveFile(std::array<Square, 64>& squares_bishops, std::array<Square, 64>& squares_rooks, std::vector<unsigned long long>& attacks_array);
-	SaveFile() = default;
-	SaveFile(SaveFile&);
-
-	void store(std::ofstream& file) const;
-	void load(std::ifstream& file);
-};
-
-SaveFile loadMagics();
-bool storeMagics(std::array<Square, 64>& squares_bishops, std::array<Square, 64>& squares_rooks, std::vector<unsigned long long>& attacks_array);
+/*
+	Writes src/MagicNumbers.h with the mask, magic number, bits used and index in the attacks array of every square,
+	the attacks array itself is generated at compile time from them (see MagicBitboards.cpp).
+*/
+bool storeMagics(const std::array<Square, 64>& squares_bishops, const std::array<Square, 64>& squares_rooks, size_t attacks_array_size);
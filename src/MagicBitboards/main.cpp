@@ -163,8 +163,8 @@ int main() {
 		}
 
 		// Save to file 
-		if (storeMagics(squares_bishops, squares_rooks, attacks_array)) {
-			cout << "Saved magic numbers to file magic_numbers.\n";
+		if (storeMagics(squares_bishops, squares_rooks, attacks_array.size())) {
+			cout << "Saved magic numbers to MagicNumbers.h.\n";
 		}
 		else {
 			cout << "Couldn't save magic numbers to file.\n";
@@ -0,0 +1,145 @@
+#pragma once
+#include <array>
+
+// Generated by GenerateMagicBitboards (src/MagicBitboards), do not edit
+
+struct SquareMagic {
+	unsigned long long mask, magic_number; // Mask is inverted (black magic bitboards)
+	int bits_used, index_attack_array;
+};
+
+constexpr int sliding_attacks_array_size = 113444;
+
+constexpr std::array<SquareMagic, 64> bishops_magics = {{
+	{ 0xffbfdfeff7fbfdff, 0xf20064040a0048ed, 9, 106428 },
+	{ 0xffffbfdfeff7fbff, 0x5f0046080501000a, 5, 106904 },
+	{ 0xffffffbfdfeff5ff, 0x6b00469031000074, 9, 106936 },
+	{ 0xffffffffbfddebff, 0xc700740100010040, 6, 107408 },
+	{ 0xfffffffffdbbd7ff, 0xcb0044c000020000, 6, 107471 },
+	{ 0xfffffffdfbf7afff, 0x9b00500820020077, 5, 107535 },
+	{ 0xfffffdfbf7efdfff, 0xf40028141009007d, 5, 107567 },
+	{ 0xfffdfbf7efdfbfff, 0x7500324108201037, 6, 107599 },
+	{ 0xffdfeff7fbfdffff, 0xba00114210042067, 5, 107663 },
+	{ 0xffbfdfeff7fbffff, 0xaf0034100408087e, 5, 107695 },
+	{ 0xffffbfdfeff5ffff, 0xfb0004341882012f, 5, 107727 },
+	{ 0xffffffbfddebffff, 0xea00582040400106, 5, 107759 },
+	{ 0xfffffffdbbd7ffff, 0x7b004410436112e9, 5, 107791 },
+	{ 0xfffffdfbf7afffff, 0xbf0001006030082c, 5, 107823 },
+	{ 0xfffdfbf7efdfffff, 0xeb00004c10080865, 5, 107855 },
+	{ 0xfffbf7efdfbfffff, 0x7f000201010800e9, 5, 107887 },
+	{ 0xffeff7fbfdfffdff, 0xf300424802020025, 9, 107919 },
+	{ 0xffdfeff7fbfffbff, 0x9700405010010105, 5, 108425 },
+	{ 0xffbfdfeff5fff5ff, 0xef00484029024260, 9, 108457 },
+	{ 0xffffbfddebffebff, 0xbf0074280200407a, 7, 108969 },
+	{ 0xfffffdbbd7ffd7ff, 0x37007a1400a0004b, 7, 109097 },
+	{ 0xfffdfbf7afffafff, 0xb7004002011000c3, 7, 109225 },
+	{ 0xfffbf7efdfffdfff, 0x9d00400a01042014, 5, 109353 },
+	{ 0xfff7efdfbfffbfff, 0xf30048130100502b, 5, 109385 },
+	{ 0xfff7fbfdfffdfbff, 0xe600448840100413, 5, 109417 },
+	{ 0xffeff7fbfffbf7ff, 0x7f0012202008017f, 5, 109449 },
+	{ 0xffdfeff5fff5efff, 0xdb00100018004041, 7, 109481 },
+	{ 0xffbfddebffebddff, 0x7f00201104010060, 9, 109609 },
+	{ 0xfffdbbd7ffd7bbff, 0x7b00404004010043, 9, 110121 },
+	{ 0xfffbf7afffaff7ff, 0xef00468011006005, 7, 110633 },
+	{ 0xfff7efdfffdfefff, 0xbc0044050201043c, 5, 110761 },
+	{ 0xffefdfbfffbfdfff, 0xb300450002010117, 5, 110793 },
+	{ 0xfffbfdfffdfbf7ff, 0xe70047c00808106f, 5, 110825 },
+	{ 0xfff7fbfffbf7efff, 0xbb002803010810ee, 5, 110857 },
+	{ 0xffeff5fff5efdfff, 0x9f0008080004003b, 7, 110889 },
+	{ 0xffddebffebddbfff, 0xf700201800010050, 9, 111017 },
+	{ 0xffbbd7ffd7bbfdff, 0xa700410040240041, 9, 111529 },
+	{ 0xfff7afffaff7fbff, 0xf2004204100200ff, 7, 112041 },
+	{ 0xffefdfffdfeff7ff, 0x7f002404000900ff, 5, 112168 },
+	{ 0xffdfbfffbfdfefff, 0xef004062110900e7, 5, 112200 },
+	{ 0xfffdfffdfbf7efff, 0xdf00100820102807, 5, 112231 },
+	{ 0xfffbfffbf7efdfff, 0xf70038080800026b, 5, 112263 },
+	{ 0xfff5fff5efdfbfff, 0x7d0010080400080b, 7, 112295 },
+	{ 0xffebffebddbfffff, 0x8f0000401a02101e, 7, 112423 },
+	{ 0xffd7ffd7bbfdffff, 0x6d00100202000071, 7, 112551 },
+	{ 0xffafffaff7fbfdff, 0x9f0040b00500007f, 7, 112679 },
+	{ 0xffdfffdfeff7fbff, 0xfd00780a1400007f, 5, 112807 },
+	{ 0xffbfffbfdfeff7ff, 0xe70040c4104804a1, 5, 112838 },
+	{ 0xfffffdfbf7efdfff, 0xff00222802410057, 5, 112870 },
+	{ 0xfffffbf7efdfbfff, 0xe600120602200057, 5, 112902 },
+	{ 0xfffff5efdfbfffff, 0xfb002044040c2062, 5, 112934 },
+	{ 0xffffebddbfffffff, 0xee00400042080045, 5, 112966 },
+	{ 0xffffd7bbfdffffff, 0xff000460035404fe, 5, 112998 },
+	{ 0xffffaff7fbfdffff, 0xd700200301020007, 5, 113030 },
+	{ 0xffffdfeff7fbfdff, 0x5f00500108010063, 5, 113062 },
+	{ 0xffffbfdfeff7fbff, 0xea000902404a0276, 5, 113094 },
+	{ 0xfffdfbf7efdfbfff, 0xfe000600622030ed, 6, 113125 },
+	{ 0xfffbf7efdfbfffff, 0xed00010012022033, 5, 113188 },
+	{ 0xfff5efdfbfffffff, 0xda00004200164817, 5, 113220 },
+	{ 0xffebddbfffffffff, 0xf300020002020273, 5, 113252 },
+	{ 0xffd7bbfdffffffff, 0xbd0022104009026d, 5, 113284 },
+	{ 0xffaff7fbfdffffff, 0x7b00140820040415, 5, 113316 },
+	{ 0xffdfeff7fbfdffff, 0xfb0020003c080064, 5, 113348 },
+	{ 0xffbfdfeff7fbfdff, 0x7e006288004c004a, 6, 113380 },
+}};
+
+constexpr std::array<SquareMagic, 64> rooks_magics = {{
+	{ 0xfffefefefefefe81, 0xc700104100800061, 12, 0 },
+	{ 0xfffdfdfdfdfdfd83, 0xff00208100c0000f, 11, 4096 },
+	{ 0xfffbfbfbfbfbfb85, 0xfb002000090040b1, 11, 6144 },
+	{ 0xfff7f7f7f7f7f789, 0xf100210008100003, 11, 8192 },
+	{ 0xffefefefefefef91, 0xfb0010280100042e, 11, 10240 },
+	{ 0xffdfdfdfdfdfdfa1, 0xfe0004104a000835, 11, 12288 },
+	{ 0xffbfbfbfbfbfbfc1, 0xbe000804020040a1, 11, 14336 },
+	{ 0xff7f7f7f7f7f7f81, 0xf600020040840073, 12, 16384 },
+	{ 0xfffefefefefe81ff, 0x3e006000300010e8, 11, 20480 },
+	{ 0xfffdfdfdfdfd83ff, 0xf700401000200043, 10, 22528 },
+	{ 0xfffbfbfbfbfb85ff, 0xbc00201008002039, 11, 23552 },
+	{ 0xfff7f7f7f7f789ff, 0xfe00600c00060060, 10, 25600 },
+	{ 0xffefefefefef91ff, 0xdb0010840800321f, 11, 26624 },
+	{ 0xffdfdfdfdfdfa1ff, 0xf500400204000102, 11, 28672 },
+	{ 0xffbfbfbfbfbfc1ff, 0xda00101207004064, 11, 30680 },
+	{ 0xff7f7f7f7f7f81ff, 0xfd00300108800038, 11, 32704 },
+	{ 0xfffefefefe81feff, 0xb90020800040009b, 11, 34752 },
+	{ 0xfffdfdfdfd83fdff, 0xbc00424002201005, 10, 36800 },
+	{ 0xfffbfbfbfb85fbff, 0xe500410020010034, 10, 37824 },
+	{ 0xfff7f7f7f789f7ff, 0xb900420022000851, 10, 38848 },
+	{ 0xffefefefef91efff, 0xfb00110008010044, 10, 39872 },
+	{ 0xffdfdfdfdfa1dfff, 0x1f0008011040206c, 10, 40896 },
+	{ 0xffbfbfbfbfc1bfff, 0xfe00040018d0006e, 10, 41920 },
+	{ 0xff7f7f7f7f817fff, 0xf50006000084005d, 11, 42944 },
+	{ 0xfffefefe81fefeff, 0xeb00420600210085, 11, 44992 },
+	{ 0xfffdfdfd83fdfdff, 0xd900200040100049, 10, 47040 },
+	{ 0xfffbfbfb85fbfbff, 0xcf00410100200277, 10, 48064 },
+	{ 0xfff7f7f789f7f7ff, 0x6f001001000900a3, 10, 49088 },
+	{ 0xffefefef91efefff, 0xf7000501001800d0, 10, 50112 },
+	{ 0xffdfdfdfa1dfdfff, 0xab00010100040078, 10, 51136 },
+	{ 0xffbfbfbfc1bfbfff, 0xab00020400100867, 10, 52160 },
+	{ 0xff7f7f7f817f7fff, 0xff0024820014015f, 11, 53184 },
+	{ 0xfffefe81fefefeff, 0x7a00204000800095, 11, 55232 },
+	{ 0xfffdfd83fdfdfdff, 0xd600201001400140, 10, 57280 },
+	{ 0xfffbfb85fbfbfbff, 0xb700200301001046, 10, 58304 },
+	{ 0xfff7f789f7f7f7ff, 0xbe00200602001042, 10, 59328 },
+	{ 0xffefef91efefefff, 0xdc00020046000ca4, 10, 60352 },
+	{ 0xffdfdfa1dfdfdfff, 0x7f00244008011020, 10, 61376 },
+	{ 0xffbfbfc1bfbfbfff, 0xbe0001105400082e, 10, 62400 },
+	{ 0xff7f7f817f7f7fff, 0xed0044840200004b, 11, 63424 },
+	{ 0xfffe81fefefefeff, 0xba00408a01020020, 11, 65472 },
+	{ 0xfffd83fdfdfdfdff, 0xdf00400500810029, 10, 67520 },
+	{ 0xfffb85fbfbfbfbff, 0xfb00200100410037, 10, 68544 },
+	{ 0xfff789f7f7f7f7ff, 0xfb00210030010048, 10, 69568 },
+	{ 0xffef91efefefefff, 0xff00020010a20009, 10, 70592 },
+	{ 0xffdfa1dfdfdfdfff, 0xdf00040001010028, 10, 71616 },
+	{ 0xffbfc1bfbfbfbfff, 0xfc00020810040063, 10, 72640 },
+	{ 0xff7f817f7f7f7fff, 0xdf00089401420003, 11, 73664 },
+	{ 0xff81fefefefefeff, 0x6b00020860140350, 11, 75712 },
+	{ 0xff83fdfdfdfdfdff, 0x4f00020843205250, 10, 77760 },
+	{ 0xff85fbfbfbfbfbff, 0xb900405200822200, 10, 78784 },
+	{ 0xff89f7f7f7f7f7ff, 0xdf00104200222a00, 10, 79808 },
+	{ 0xff91efefefefefff, 0xef00180104510100, 10, 80832 },
+	{ 0xffa1dfdfdfdfdfff, 0xf700010008040100, 10, 81856 },
+	{ 0xffc1bfbfbfbfbfff, 0xf400040060512040, 10, 82880 },
+	{ 0xff817f7f7f7f7fff, 0xce0000080c101210, 11, 83904 },
+	{ 0x81fefefefefefeff, 0xf10001800111003d, 12, 85952 },
+	{ 0x83fdfdfdfdfdfdff, 0xfe00208040010037, 11, 90048 },
+	{ 0x85fbfbfbfbfbfbff, 0xdb00200100400673, 11, 92096 },
+	{ 0x89f7f7f7f7f7f7ff, 0x7c00100001001c47, 11, 94144 },
+	{ 0x91efefefefefefff, 0xef00504800010053, 11, 96192 },
+	{ 0xa1dfdfdfdfdfdfff, 0xa70000830112007a, 11, 98240 },
+	{ 0xc1bfbfbfbfbfbfff, 0xe3000045080a101c, 11, 100284 },
+	{ 0x817f7f7f7f7f7fff, 0x9e00002104814402, 12, 102332 },
+}};
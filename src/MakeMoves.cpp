@@ -5,7 +5,7 @@
 #include "Zobrist.h"
 #include "EvaluateNNUE.h"
 
-MoveInfo makeMove(const unsigned short move, Player& player, Player& opponent, unsigned long long hash, bool update_nnue) {
+MoveInfo makeMove(const unsigned short move, Player& player, Player& opponent, unsigned long long hash, NNUE* nnue) {
 	unsigned short flag = getMoveFlag(move);
 	location start_square = getStartSquare(move);
 	location final_square = getFinalSquare(move);
@@ -26,6 +26,10 @@ MoveInfo makeMove(const unsigned short move, Player& player, Player& opponent, u
 		opponent.locations.en_passant_target = 0;
 	}
 
+	// Changes of the move are recorded in a new ply of the NNUE
+	if (nnue)
+		nnue->push();
+
 	// Update bitboards, hash and NNUE
 	location location_en_passant_pawn;
 	switch (flag) {
@@ -33,8 +37,8 @@ MoveInfo makeMove(const unsigned short move, Player& player, Player& opponent, u
 		player.bitboards.removePawn(start_square);
 		player.bitboards.addPawn(final_square);
 
-		if (update_nnue)	
-			nnue.movePiece(Pawn, start_square, final_square, player, opponent);
+		if (nnue)	
+			nnue->movePiece(Pawn, start_square, final_square, player, opponent);
 
 		if (player.is_white) {
 			hash ^= zobrist_keys.white_pawn[start_square];
@@ -51,8 +55,8 @@ MoveInfo makeMove(const unsigned short move, Player& player, Player& opponent, u
 		player.bitboards.removePawn(start_square);
 		player.bitboards.addPawn(final_square);
 
-		if (update_nnue)
-			nnue.movePiece(Pawn, start_square, final_square, player, opponent);
+		if (nnue)
+			nnue->movePiece(Pawn, start_square, final_square, player, opponent);
 
 		player.locations.en_passant_target = player.is_white ? (final_square - 8) : (final_square + 8);
 
@@ -72,8 +76,8 @@ MoveInfo makeMove(const unsigned short move, Player& player, Player& opponent, u
 		player.bitboards.removeKnight(start_square);
 		player.bitboards.addKnight(final_square);
 
-		if (update_nnue)
-			nnue.movePiece(Knight, start_square, final_square, player, opponent);
+		if (nnue)
+			nnue->movePiece(Knight, start_square, final_square, player, opponent);
 
 		if (player.is_white) {
 			hash ^= zobrist_keys.white_knight[start_square];
@@ -90,8 +94,8 @@ MoveInfo makeMove(const unsigned short move, Player& player, Player& opponent, u
 		player.bitboards.removeBishop(start_square);
 		player.bitboards.addBishop(final_square);
 
-		if (update_nnue)
-			nnue.movePiece(Bishop, start_square, final_square, player, opponent);
+		if (nnue)
+			nnue->movePiece(Bishop, start_square, final_square, player, opponent);
 
 		if (player.is_white) {
 			hash ^= zobrist_keys.white_bishop[start_square];
@@ -108,8 +112,8 @@ MoveInfo makeMove(const unsigned short move, Player& player, Player& opponent, u
 		player.bitboards.removeRook(start_square);
 		player.bitboards.addRook(final_square);
 
-		if (update_nnue)
-			nnue.movePiece(Rook, start_square, final_square, player, opponent);
+		if (nnue)
+			nnue->movePiece(Rook, start_square, final_square, player, opponent);
 
 		if (player.is_white) {
 			hash ^= zobrist_keys.white_rook[start_square];
@@ -138,8 +142,8 @@ MoveInfo makeMove(const unsigned short move, Player& player, Player& opponent, u
 		player.bitboards.removeQueen(start_square);
 		player.bitboards.addQueen(final_square);
 
-		if (update_nnue)
-			nnue.movePiece(Queen, start_square, final_square, player, opponent);
+		if (nnue)
+			nnue->movePiece(Queen, start_square, final_square, player, opponent);
 
 		if (player.is_white) {
 			hash ^= zobrist_keys.white_queen[start_square];
@@ -160,8 +164,8 @@ MoveInfo makeMove(const unsigned short move, Player& player, Player& opponent, u
 		player.bitboards.all_pieces = player.bitboards.friendly_pieces | opponent.bitboards.friendly_pieces;
 		opponent.bitboards.all_pieces = player.bitboards.all_pieces;
 		
-		if (update_nnue)
-			nnue.setPosition(player, opponent);
+		if (nnue)
+			nnue->movePiece(King, start_square, final_square, player, opponent);
 
 		if (player.is_white) {
 			hash ^= zobrist_keys.white_king[start_square];
@@ -209,8 +213,10 @@ MoveInfo makeMove(const unsigned short move, Player& player, Player& opponent, u
 		player.bitboards.all_pieces = player.bitboards.friendly_pieces | opponent.bitboards.friendly_pieces;
 		opponent.bitboards.all_pieces = player.bitboards.all_pieces;
 
-		if (update_nnue)
-			nnue.setPosition(player, opponent);
+		if (nnue) {
+			nnue->movePiece(King, start_square, final_square, player, opponent);
+			nnue->movePiece(Rook, initial_square_rook_king_side, final_square - 1, player, opponent);
+		}
 
 		// Update hash
 		if (player.is_white) {
@@ -251,8 +257,10 @@ MoveInfo makeMove(const unsigned short move, Player& player, Player& opponent, u
 		player.bitboards.all_pieces = player.bitboards.friendly_pieces | opponent.bitboards.friendly_pieces;
 		opponent.bitboards.all_pieces = player.bitboards.all_pieces;
 		
-		if (update_nnue)
-			nnue.setPosition(player, opponent);
+		if (nnue) {
+			nnue->movePiece(King, start_square, final_square, player, opponent);
+			nnue->movePiece(Rook, initial_square_rook_queen_side, final_square + 1, player, opponent);
+		}
 
 		// Update hash
 		if (player.is_white) {
@@ -279,9 +287,9 @@ MoveInfo makeMove(const unsigned short move, Player& player, Player& opponent, u
 		opponent.bitboards.removePawn(location_en_passant_pawn);
 		opponent.num_pawns--;
 
-		if (update_nnue) {
-			nnue.movePiece(Pawn, start_square, final_square, player, opponent);
-			nnue.removePiece(Pawn, location_en_passant_pawn, opponent, player);
+		if (nnue) {
+			nnue->movePiece(Pawn, start_square, final_square, player, opponent);
+			nnue->removePiece(Pawn, location_en_passant_pawn, opponent, player);
 		}
 
 		// Update hash
@@ -304,9 +312,9 @@ MoveInfo makeMove(const unsigned short move, Player& player, Player& opponent, u
 		player.num_pawns--;
 		player.num_knights++;
 
-		if (update_nnue) {
-			nnue.removePiece(Pawn, start_square, player, opponent);
-			nnue.addPiece(Knight, final_square, player, opponent);
+		if (nnue) {
+			nnue->removePiece(Pawn, start_square, player, opponent);
+			nnue->addPiece(Knight, final_square, player, opponent);
 		}
 
 		if (player.is_white) {
@@ -326,9 +334,9 @@ MoveInfo makeMove(const unsigned short move, Player& player, Player& opponent, u
 		player.num_pawns--;
 		player.num_bishops++;
 
-		if (update_nnue) {
-			nnue.removePiece(Pawn, start_square, player, opponent);
-			nnue.addPiece(Bishop, final_square, player, opponent);
+		if (nnue) {
+			nnue->removePiece(Pawn, start_square, player, opponent);
+			nnue->addPiece(Bishop, final_square, player, opponent);
 		}
 
 		if (player.is_white) {
@@ -348,9 +356,9 @@ MoveInfo makeMove(const unsigned short move, Player& player, Player& opponent, u
 		player.num_pawns--;
 		player.num_rooks++;
 
-		if (update_nnue) {
-			nnue.removePiece(Pawn, start_square, player, opponent);
-			nnue.addPiece(Rook, final_square, player, opponent);
+		if (nnue) {
+			nnue->removePiece(Pawn, start_square, player, opponent);
+			nnue->addPiece(Rook, final_square, player, opponent);
 		}
 
 		if (player.is_white) {
@@ -370,9 +378,9 @@ MoveInfo makeMove(const unsigned short move, Player& player, Player& opponent, u
 		player.num_pawns--;
 		player.num_queens++;
 
-		if (update_nnue) {
-			nnue.removePiece(Pawn, start_square, player, opponent);
-			nnue.addPiece(Queen, final_square, player, opponent);
+		if (nnue) {
+			nnue->removePiece(Pawn, start_square, player, opponent);
+			nnue->addPiece(Queen, final_square, player, opponent);
 		}
 
 		if (player.is_white) {
@@ -401,8 +409,8 @@ MoveInfo makeMove(const unsigned short move, Player& player, Player& opponent, u
 			opponent.num_pawns--;
 			capture_type = pawn_capture;
 
-			if (update_nnue)	
-				nnue.removePiece(Pawn, final_square, opponent, player);
+			if (nnue)	
+				nnue->removePiece(Pawn, final_square, opponent, player);
 
 			if (opponent.is_white) hash ^= zobrist_keys.white_pawn[final_square];
 			else hash ^= zobrist_keys.black_pawn[final_square];
@@ -412,8 +420,8 @@ MoveInfo makeMove(const unsigned short move, Player& player, Player& opponent, u
 			opponent.num_knights--;
 			capture_type = knight_capture;
 
-			if (update_nnue)	
-				nnue.removePiece(Knight, final_square, opponent, player);
+			if (nnue)	
+				nnue->removePiece(Knight, final_square, opponent, player);
 
 			if (opponent.is_white) hash ^= zobrist_keys.white_knight[final_square];
 			else hash ^= zobrist_keys.black_knight[final_square];
@@ -423,8 +431,8 @@ MoveInfo makeMove(const unsigned short move, Player& player, Player& opponent, u
 			opponent.num_bishops--;
 			capture_type = bishop_capture;
 
-			if (update_nnue)	
-				nnue.removePiece(Bishop, final_square, opponent, player);
+			if (nnue)	
+				nnue->removePiece(Bishop, final_square, opponent, player);
 
 			if (opponent.is_white) hash ^= zobrist_keys.white_bishop[final_square];
 			else hash ^= zobrist_keys.black_bishop[final_square];
@@ -434,8 +442,8 @@ MoveInfo makeMove(const unsigned short move, Player& player, Player& opponent, u
 			opponent.num_rooks--;
 			capture_type = rook_capture;
 
-			if (update_nnue)	
-				nnue.removePiece(Rook, final_square, opponent, player);
+			if (nnue)	
+				nnue->removePiece(Rook, final_square, opponent, player);
 
 			if (opponent.is_white) hash ^= zobrist_keys.white_rook[final_square];
 			else hash ^= zobrist_keys.black_rook[final_square];
@@ -459,8 +467,8 @@ MoveInfo makeMove(const unsigned short move, Player& player, Player& opponent, u
 			opponent.num_queens--;
 			capture_type = queen_capture;
 
-			if (update_nnue)	
-				nnue.removePiece(Queen, final_square, opponent, player);
+			if (nnue)	
+				nnue->removePiece(Queen, final_square, opponent, player);
 
 			if (opponent.is_white) hash ^= zobrist_keys.white_queen[final_square];
 			else hash ^= zobrist_keys.black_queen[final_square];
@@ -477,15 +485,11 @@ MoveInfo makeMove(const unsigned short move, Player& player, Player& opponent, u
 	player.bitboards.attacks = player_attacks.attacks_bitboard;
 	opponent.bitboards.squares_to_uncheck = player_attacks.opponent_squares_to_uncheck;
 	
-	// Set opponent's pins, since opponent is next to play
-	player.move_id++;
-	opponent.move_id++;
-	setPins(opponent, player);
+	// Opponent's pins are computed when its moves are generated
+	nextMoveId(player, opponent);
 
 	// Flip turn to move
 	hash ^= zobrist_keys.is_black_to_move;
-	if (update_nnue)
-		nnue.flipSides();
 
 	return { 
 		player_could_castle_king_side, 
@@ -498,7 +502,7 @@ MoveInfo makeMove(const unsigned short move, Player& player, Player& opponent, u
 	};
 }
 
-void unmakeMove(const unsigned short move, Player& player, Player& opponent, const MoveInfo& move_info, bool update_nnue) {
+void unmakeMove(const unsigned short move, Player& player, Player& opponent, const MoveInfo& move_info, NNUE* nnue) {
 	unsigned short flag = getMoveFlag(move);
 	location start_square = getStartSquare(move);
 	location final_square = getFinalSquare(move);
@@ -512,8 +516,9 @@ void unmakeMove(const unsigned short move, Player& player, Player& opponent, con
 	opponent.can_castle_king_side = move_info.opponent_could_castle_king_side;
 	opponent.can_castle_queen_side = move_info.opponent_could_castle_queen_side;
 
-	if (update_nnue)
-		nnue.flipSides();
+	// Return to the accumulator of the previous ply
+	if (nnue)
+		nnue->pop();
 
 	// Revert piece moved to start square
 	location location_en_passant_pawn;
@@ -522,18 +527,12 @@ void unmakeMove(const unsigned short move, Player& player, Player& opponent, con
 		player.bitboards.removePawn(final_square);
 		player.bitboards.addPawn(start_square);
 
-		if (update_nnue)
-			nnue.movePiece(Pawn, final_square, start_square, player, opponent);
-
 		break;
 
 	case pawn_move_two_squares:
 		player.bitboards.removePawn(final_square);
 		player.bitboards.addPawn(start_square);
 
-		if (update_nnue)
-			nnue.movePiece(Pawn, final_square, start_square, player, opponent);
-
 		player.locations.en_passant_target = 0;
 
 		break;
@@ -542,36 +541,24 @@ void unmakeMove(const unsigned short move, Player& player, Player& opponent, con
 		player.bitboards.removeKnight(final_square);
 		player.bitboards.addKnight(start_square);
 
-		if (update_nnue)
-			nnue.movePiece(Knight, final_square, start_square, player, opponent);
-
 		break;
 
 	case bishop_move:
 		player.bitboards.removeBishop(final_square);
 		player.bitboards.addBishop(start_square);
 
-		if (update_nnue)
-			nnue.movePiece(Bishop, final_square, start_square, player, opponent);
-
 		break;
 
 	case rook_move:
 		player.bitboards.removeRook(final_square);
 		player.bitboards.addRook(start_square);
 
-		if (update_nnue)
-			nnue.movePiece(Rook, final_square, start_square, player, opponent);
-
 		break;
 
 	case queen_move:
 		player.bitboards.removeQueen(final_square);
 		player.bitboards.addQueen(start_square);
 
-		if (update_nnue)
-			nnue.movePiece(Queen, final_square, start_square, player, opponent);
-
 		break;
 
 	case king_move:
@@ -582,9 +569,6 @@ void unmakeMove(const unsigned short move, Player& player, Player& opponent, con
 		player.bitboards.all_pieces = player.bitboards.friendly_pieces | opponent.bitboards.friendly_pieces;
 		opponent.bitboards.all_pieces = player.bitboards.all_pieces;
 
-		if (update_nnue)
-			nnue.setPosition(player, opponent);
-
 		break;
 
 	case castle_king_side:
@@ -599,9 +583,6 @@ void unmakeMove(const unsigned short move, Player& player, Player& opponent, con
 		player.bitboards.all_pieces = player.bitboards.friendly_pieces | opponent.bitboards.friendly_pieces;
 		opponent.bitboards.all_pieces = player.bitboards.all_pieces;
 
-		if (update_nnue)
-			nnue.setPosition(player, opponent);
-
 		break;
 
 	case castle_queen_side:
@@ -616,9 +597,6 @@ void unmakeMove(const unsigned short move, Player& player, Player& opponent, con
 		player.bitboards.all_pieces = player.bitboards.friendly_pieces | opponent.bitboards.friendly_pieces;
 		opponent.bitboards.all_pieces = player.bitboards.all_pieces;
 
-		if (update_nnue)
-			nnue.setPosition(player, opponent);
-
 		break;
 
 	case en_passant:
@@ -630,11 +608,6 @@ void unmakeMove(const unsigned short move, Player& player, Player& opponent, con
 		opponent.bitboards.addPawn(location_en_passant_pawn);
 		opponent.num_pawns++;
 
-		if (update_nnue) {
-			nnue.movePiece(Pawn, final_square, start_square, player, opponent);
-			nnue.addPiece(Pawn, location_en_passant_pawn, opponent, player);
-		}
-
 		break;
 
 	case promotion_knight:
@@ -643,11 +616,6 @@ void unmakeMove(const unsigned short move, Player& player, Player& opponent, con
 		player.num_pawns++;
 		player.num_knights--;
 
-		if (update_nnue) {
-			nnue.removePiece(Knight, final_square, player, opponent);
-			nnue.addPiece(Pawn, start_square, player, opponent);
-		}
-
 		break;
 
 	case promotion_bishop:
@@ -656,11 +624,6 @@ void unmakeMove(const unsigned short move, Player& player, Player& opponent, con
 		player.num_pawns++;
 		player.num_bishops--;
 
-		if (update_nnue) {
-			nnue.removePiece(Bishop, final_square, player, opponent);
-			nnue.addPiece(Pawn, start_square, player, opponent);
-		}
-
 		break;
 
 	case promotion_rook:
@@ -669,11 +632,6 @@ void unmakeMove(const unsigned short move, Player& player, Player& opponent, con
 		player.num_pawns++;
 		player.num_rooks--;
 
-		if (update_nnue) {
-			nnue.removePiece(Rook, final_square, player, opponent);
-			nnue.addPiece(Pawn, start_square, player, opponent);
-		}
-
 		break;
 
 	case promotion_queen:
@@ -682,11 +640,6 @@ void unmakeMove(const unsigned short move, Player& player, Player& opponent, con
 		player.num_pawns++;
 		player.num_queens--;
 
-		if (update_nnue) {
-			nnue.removePiece(Queen, final_square, player, opponent);
-			nnue.addPiece(Pawn, start_square, player, opponent);
-		}
-
 		break;
 
 	default: // Null Move
@@ -701,45 +654,30 @@ void unmakeMove(const unsigned short move, Player& player, Player& opponent, con
 		opponent.bitboards.addPawn(final_square);
 		opponent.num_pawns++;
 
-		if (update_nnue)
-			nnue.addPiece(Pawn, final_square, opponent, player);
-
 		break;
 
 	case knight_capture:
 		opponent.bitboards.addKnight(final_square);
 		opponent.num_knights++;
 
-		if (update_nnue)
-			nnue.addPiece(Knight, final_square, opponent, player);
-
 		break;
 
 	case bishop_capture:
 		opponent.bitboards.addBishop(final_square);
 		opponent.num_bishops++;
 		
-		if (update_nnue)
-			nnue.addPiece(Bishop, final_square, opponent, player);
-		
 		break;
 
 	case rook_capture:
 		opponent.bitboards.addRook(final_square);
 		opponent.num_rooks++;
 		
-		if (update_nnue)
-			nnue.addPiece(Rook, final_square, opponent, player);
-		
 		break;
 
 	case queen_capture:
 		opponent.bitboards.addQueen(final_square);
 		opponent.num_queens++;
 		
-		if (update_nnue)
-			nnue.addPiece(Queen, final_square, opponent, player);
-		
 		break;
 
 	default:
@@ -749,8 +687,6 @@ void unmakeMove(const unsigned short move, Player& player, Player& opponent, con
 	player.bitboards.all_pieces = player.bitboards.friendly_pieces | opponent.bitboards.friendly_pieces;
 	opponent.bitboards.all_pieces = player.bitboards.all_pieces;
 
-	// Reset player's pins, since player is next to play
-	player.move_id++;
-	opponent.move_id++;
-	setPins(player, opponent);
+	// Player's pins are computed when its moves are generated
+	nextMoveId(player, opponent);
 }
@@ -1,6 +1,8 @@
 #pragma once
 #include "Player.h"
 
+class NNUE;
+
 constexpr short no_capture = 0;
 constexpr short pawn_capture = 1;
 constexpr short knight_capture = 2;
@@ -15,7 +17,7 @@ struct MoveInfo {
 	unsigned long long hash;
 };
 
-// Returns move info to be used in unmakeMove.
-MoveInfo makeMove(const unsigned short move, Player& player, Player& opponent, unsigned long long hash, bool update_nnue=true);
+// Returns move info to be used in unmakeMove, the accumulator of nnue is updated if it is not null.
+MoveInfo makeMove(const unsigned short move, Player& player, Player& opponent, unsigned long long hash, NNUE* nnue=nullptr);
 
-void unmakeMove(const unsigned short move, Player& player, Player& opponent, const MoveInfo& move_info, bool update_nnue=true);
+void unmakeMove(const unsigned short move, Player& player, Player& opponent, const MoveInfo& move_info, NNUE* nnue=nullptr);
@@ -0,0 +1,164 @@
+#include "MovePicker.h"
+#include "HistoryTable.h"
+#include "Moves.h"
+#include "OrderingKernels.h"
+#include "PieceTypes.h"
+#include "Player.h"
+#include <array>
+
+// Value of a piece of each PieceType, a king captures for free (only considering one move)
+constexpr std::array<int, 6> piece_values = { 100, 320, 330, 500, 900, 0 };
+
+// Fastest version supported by the CPU, picked once at startup
+static const BestMoveIndexFn best_move_index = selectBestMoveIndex();
+
+inline int victimValue(const Player& opponent, location square);
+inline int promotionValue(unsigned short move);
+
+MovePicker::MovePicker(Player& player, Player& opponent, unsigned short tt_move, const std::array<unsigned short, 2>& killer_moves_at_ply,
+					   const HistoryTable& history_table)
+	: player(player), opponent(opponent), history_table(history_table), opponent_attacks(opponent.bitboards.attacks),
+	  squares_to_uncheck(player.bitboards.squares_to_uncheck), tt_move(tt_move), killer_moves(killer_moves_at_ply) {}
+
+unsigned short MovePicker::nextMove() {
+	opponent.bitboards.attacks = opponent_attacks;
+	player.bitboards.squares_to_uncheck = squares_to_uncheck;
+
+	switch (stage) {
+	case TTMove:
+		stage = GenerateCaptures;
+		if (tt_move != NULL_MOVE && isLegal(tt_move, player, opponent)) return tt_move;
+		[[fallthrough]];
+
+	case GenerateCaptures:
+		moves.generateMoves(player, opponent, Captures);
+		scoreCaptures();
+		stage = GoodCaptures;
+		[[fallthrough]];
+
+	case GoodCaptures:
+		if (unsigned short move = nextBestMove()) return move;
+		stage = KillerMoves;
+		[[fallthrough]];
+
+	case KillerMoves:
+		while (index_killer < 2) {
+			unsigned short move = killer_moves[index_killer++];
+			if (move == NULL_MOVE || move == tt_move || (index_killer == 2 && move == killer_moves[0])) continue;
+
+			// Only quiet moves, captures and promotions were alredy given
+			if (isPromotion(move) || getMoveFlag(move) == en_passant || isCapture(move, opponent.bitboards.friendly_pieces)) continue;
+
+			if (isLegal(move, player, opponent)) return move;
+		}
+		stage = GenerateQuiets;
+		[[fallthrough]];
+
+	case GenerateQuiets:
+		moves.generateMoves(player, opponent, Quiets);
+		scoreQuiets();
+		stage = QuietMoves;
+		[[fallthrough]];
+
+	case QuietMoves:
+		if (unsigned short move = nextBestMove()) return move;
+		stage = LosingCaptures;
+		[[fallthrough]];
+
+	case LosingCaptures:
+		if (index_losing_capture < num_losing_captures) return losing_captures[index_losing_capture++];
+		stage = Done;
+		[[fallthrough]];
+
+	case Done:
+		return NULL_MOVE;
+	}
+
+	return NULL_MOVE;
+}
+
+/*
+	Scores are encoded as in Moves::orderMoves, (score << 3) + 7 - (i / 16), which is what best_move_index expects.
+	Moves that must not be given again (TT move, killer moves) or are given in a later stage (losing captures) are
+	left with a score of 0.
+*/
+void MovePicker::scoreCaptures() {
+	num_moves_left = 0;
+
+	for (int i = 0; i < moves.num_moves; i++) {
+		unsigned short move = moves[i];
+		scores[i] = 0;
+
+		if (move == tt_move) continue;
+
+		location final_square = getFinalSquare(move);
+		int victim_value = (getMoveFlag(move) == en_passant) ? piece_values[Pawn] : victimValue(opponent, final_square);
+		int gain = victim_value + promotionValue(move);
+
+		// MVV-LVA, most valuable victim first, then least valuable attacker
+		PieceType piece_type = getPieceType(move);
+		int piece_value = isPromotion(move) ? 0 : piece_values[piece_type];
+
+		if (((1LL << final_square) & opponent.bitboards.attacks) && piece_value > gain) {
+			losing_captures[num_losing_captures++] = move;
+			continue;
+		}
+
+		int score = gain + (King - piece_type) + 1;
+		scores[i] = (score << 3) + 7 - (i / 16);
+		num_moves_left++;
+	}
+}
+
+void MovePicker::scoreQuiets() {
+	num_moves_left = 0;
+
+	for (int i = 0; i < moves.num_moves; i++) {
+		unsigned short move = moves[i];
+		scores[i] = 0;
+
+		if (move == tt_move || move == killer_moves[0] || move == killer_moves[1]) continue;
+
+		location final_square = getFinalSquare(move);
+		PieceType piece_type = getPieceType(move);
+
+		// History values from 0 to 40, moving to a defended square is penalized by the value of the piece
+		int score = 1000 + static_cast<int>(history_table.get(player.is_white, piece_type, final_square) * 40);
+		if ((1LL << final_square) & opponent.bitboards.attacks)
+			score -= piece_values[piece_type];
+
+		scores[i] = (score << 3) + 7 - (i / 16);
+		num_moves_left++;
+	}
+}
+
+unsigned short MovePicker::nextBestMove() {
+	if (num_moves_left == 0) return NULL_MOVE;
+	num_moves_left--;
+
+	int idx = best_move_index(scores, moves.num_moves);
+
+	scores[idx] = 0;
+	return moves[idx];
+}
+
+inline int victimValue(const Player& opponent, location square) {
+	unsigned long long bitboard = 1LL << square;
+	if (opponent.bitboards.pawns & bitboard)		return piece_values[Pawn];
+	else if (opponent.bitboards.knights & bitboard) return piece_values[Knight];
+	else if (opponent.bitboards.bishops & bitboard) return piece_values[Bishop];
+	else if (opponent.bitboards.rooks & bitboard)	return piece_values[Rook];
+	else if (opponent.bitboards.queens & bitboard)	return piece_values[Queen];
+	return 0; // Promotion without capture
+}
+
+// Value gained by promoting the pawn, 0 if the move is not a promotion
+inline int promotionValue(unsigned short move) {
+	switch (getMoveFlag(move)) {
+	case promotion_knight:	return piece_values[Knight] - piece_values[Pawn];
+	case promotion_bishop:	return piece_values[Bishop] - piece_values[Pawn];
+	case promotion_rook:	return piece_values[Rook] - piece_values[Pawn];
+	case promotion_queen:	return piece_values[Queen] - piece_values[Pawn];
+	default:				return 0;
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "HistoryTable.h"
+#include "Moves.h"
+#include "Player.h"
+#include <array>
+
+/*
+	Gives the moves of a position one at a time for the main search, generating and scoring them in stages, so that
+	a node that fails high on one of the first moves doesn't pay for generating and ordering all of them:
+		1. Move from TT if it is legal
+		2. Captures and promotions that don't lose material, ordered by MVV-LVA
+		3. Killer moves if they are legal quiet moves
+		4. Quiet moves, ordered by the history heuristic
+		5. Losing captures (piece captured is worth less than the capturing piece and the square is defended)
+	Each move is given only once, the moves of later stages skip the moves alredy given by earlier stages.
+*/
+class MovePicker {
+	enum Stage { TTMove, GenerateCaptures, GoodCaptures, KillerMoves, GenerateQuiets, QuietMoves, LosingCaptures, Done };
+
+	Player& player;
+	Player& opponent;
+	const HistoryTable& history_table;
+
+	/*
+		Moves searched between calls to nextMove don't restore these bitboards (see unmakeMove), so they are
+		saved when the picker is created and restored before picking each move.
+	*/
+	unsigned long long opponent_attacks, squares_to_uncheck;
+
+	Stage stage = TTMove;
+	unsigned short tt_move;
+	std::array<unsigned short, 2> killer_moves;
+	int index_killer = 0;
+
+	Moves moves;
+	alignas(64) unsigned short scores[max_num_moves] = {};
+	int num_moves_left = 0;
+
+	std::array<unsigned short, max_num_moves> losing_captures;
+	int num_losing_captures = 0, index_losing_capture = 0;
+
+	void scoreCaptures();
+	void scoreQuiets();
+	unsigned short nextBestMove();
+
+public:
+	MovePicker(Player& player, Player& opponent, unsigned short tt_move, const std::array<unsigned short, 2>& killer_moves_at_ply,
+			   const HistoryTable& history_table);
+
+	// Returns 0 when there are no moves left
+	unsigned short nextMove();
+};
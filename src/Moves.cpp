@@ -2,6 +2,7 @@
 #include "HistoryTable.h"
 #include "Locations.h"
 #include "MagicBitboards.h"
+#include "OrderingKernels.h"
 #include "PieceTypes.h"
 #include "Player.h"
 #include "Position.h"
@@ -10,7 +11,9 @@
 #include <array>
 #include <bit>
 #include <climits>
+#ifdef USE_PEXT
 #include <immintrin.h>
+#endif
 
 constexpr unsigned long long castle_king_side_white_mask = 0b01100000;
 constexpr unsigned long long castle_queen_side_white_pieces_mask = 0b01110;
@@ -25,22 +28,50 @@ constexpr unsigned short max_score_move = USHRT_MAX;
 using std::array;
 
 inline unsigned long long slidingMoves(const MagicBitboard& magic_bitboard, unsigned long long pieces);
+inline unsigned long long pawnAttacks(bool is_white, unsigned long long pawns);
 inline void addMovesFromAttacksBitboard(location start_square, bool is_in_check, unsigned long long squares_to_uncheck, 
 										unsigned long long bitboard_attacks, unsigned short move_flag, Moves* moves);
 inline unsigned long long squaresToUncheckBishop(location opponent_king_location, location bishop_location);
 inline unsigned long long squaresToUncheckRook(location opponent_king_location, location rook_location);
 inline bool canMove(bool is_in_check, location final_square, unsigned long long squares_to_uncheck);
 inline int getPieceValue(const Player& player, location square);
-void setPin(Player& player, const Player& opponent, location piece_location, bool is_pin_diagonal);
+void setPin(const Player& player, const Player& opponent, location piece_location, bool is_pin_diagonal);
+static bool isEnPassantSafe(const Player& player, const Player& opponent, location pawn_location);
+static bool isPawnMoveLegal(unsigned short move, const Player& player, const Player& opponent, bool is_in_check);
+
+void Moves::generateMoves(const Player& player, const Player& opponent, MoveType move_type) {
+	// Each type has its own instantiation, so that generating all moves (perft) doesn't pay for the checks of the move type
+	switch (move_type) {
+	case Captures:
+		generateMovesOfType<Captures>(player, opponent);
+		break;
+	case Quiets:
+		generateMovesOfType<Quiets>(player, opponent);
+		break;
+	default:
+		generateMovesOfType<AllMoves>(player, opponent);
+		break;
+	}
+}
 
-void Moves::generateMoves(const Player& player, const Player& opponent) {
+template <MoveType move_type>
+void Moves::generateMovesOfType(const Player& player, const Player& opponent) {
 	this->num_moves = 0;
 	bool is_in_check = false;
+	updatePins(player, opponent);
+
+	// Captures (with promotions and en passants) and quiet moves can be generated separately
+	constexpr bool generate_captures = move_type != Quiets;
+	constexpr bool generate_quiets = move_type != Captures;
+
+	unsigned long long targets = ~player.bitboards.friendly_pieces;
+	if (move_type == Captures) targets &= opponent.bitboards.friendly_pieces;
+	else if (move_type == Quiets) targets &= ~opponent.bitboards.friendly_pieces;
 
 	// King moves
 	for (const short move : magic_bitboards.king_moves[player.locations.king]) {
 		short final_square = getFinalSquare(move);
-		if ((1LL << final_square) & player.bitboards.friendly_pieces) continue;
+		if (!((1LL << final_square) & targets)) continue;
 		else if ((1LL << final_square) & opponent.bitboards.attacks) continue;
 
 		this->addMove(king_move | move);
@@ -94,14 +125,15 @@ void Moves::generateMoves(const Player& player, const Player& opponent) {
 
 				if (canMove(is_in_check, new_location, player.bitboards.squares_to_uncheck)) {
 					if (new_location >= 56 || new_location <= 7) {
-						for (const short promotion : promotions) this->addMove(promotion, pawn_location, new_location);
+						if (generate_captures)
+							for (const short promotion : promotions) this->addMove(promotion, pawn_location, new_location);
 					}
-					else this->addMove(pawn_move, pawn_location, new_location);
+					else if (generate_quiets) this->addMove(pawn_move, pawn_location, new_location);
 				}
 
 				// If pawn can move two squares
 				new_location = pawn_location + move_two_squares;
-				if (canMove(is_in_check, new_location, player.bitboards.squares_to_uncheck)) {
+				if (generate_quiets && canMove(is_in_check, new_location, player.bitboards.squares_to_uncheck)) {
 					short distance = pawn_location - location_unmoved_a_pawn;
 					if ((distance <= 7 && distance >= 0) && !(player.bitboards.all_pieces & (1LL << (new_location)))) {
 						this->addMove(pawn_move_two_squares, pawn_location, new_location);
@@ -111,7 +143,7 @@ void Moves::generateMoves(const Player& player, const Player& opponent) {
 		}
 
 		// Pawn captures
-		if (!is_pinned) {
+		if (generate_captures && !is_pinned) {
 			// If pawn can capture other piece at its right
 			location new_location = pawn_location + capture_right;
 			if ((opponent.bitboards.friendly_pieces & (1LL << new_location)) && (file != right_edge) && canMove(is_in_check, new_location, player.bitboards.squares_to_uncheck)) {
@@ -130,7 +162,7 @@ void Moves::generateMoves(const Player& player, const Player& opponent) {
 				else this->addMove(pawn_move, pawn_location, new_location);
 			}
 		}
-		else if (player.pins[pawn_location].is_pin_diagonal && !is_in_check) { // If pawn can capture its pinner
+		else if (generate_captures && player.pins[pawn_location].is_pin_diagonal && !is_in_check) { // If pawn can capture its pinner
 			short distance = player.pins[pawn_location].location_pinner - pawn_location;
 			if (distance == capture_right || distance == capture_left) {
 				if (player.pins[pawn_location].location_pinner >= 56 || player.pins[pawn_location].location_pinner <= 7) {
@@ -141,44 +173,12 @@ void Moves::generateMoves(const Player& player, const Player& opponent) {
 		}
 		
 		// En Passants
-		if ((!is_pinned || player.pins[pawn_location].is_pin_diagonal) && opponent.locations.en_passant_target != 0) {
+		if (generate_captures && (!is_pinned || player.pins[pawn_location].is_pin_diagonal) && opponent.locations.en_passant_target != 0) {
 			short distance = opponent.locations.en_passant_target - pawn_location;
 			if ((distance == capture_right && file != right_edge) || (distance == capture_left && file != left_edge)) {
 
-				// Make en passant move
-				location location_pawn_captured = opponent.locations.en_passant_target - move_one_square;
-				unsigned long long all_pieces = opponent.bitboards.all_pieces ^ (1LL << pawn_location);
-				all_pieces ^= (1LL << location_pawn_captured);
-				all_pieces |= (1LL << opponent.locations.en_passant_target);
-				
-				// Check if en passant wont leave king in check
-				unsigned long long bishops_and_queens = opponent.bitboards.bishops | opponent.bitboards.queens;
-				unsigned long long rooks_and_queens   = opponent.bitboards.rooks   | opponent.bitboards.queens;
-				unsigned long long opponent_pieces    = bishops_and_queens         | rooks_and_queens;
-
-				bool can_en_passant = true;
-				int square = 0;
-				while (opponent_pieces != 0 && square <= 63) {
-					int squares_to_skip = std::countr_zero(opponent_pieces);
-					square += squares_to_skip;
-
-					unsigned long long bitboard_square = (1LL << square);
-					unsigned long long squares_to_uncheck = 0;
-
-					if (bitboard_square & bishops_and_queens) squares_to_uncheck |= squaresToUncheckBishop(player.locations.king, square);
-					if (bitboard_square & rooks_and_queens) squares_to_uncheck |= squaresToUncheckRook(player.locations.king, square);
-
-					if (((squares_to_uncheck ^ bitboard_square) & all_pieces) == 0) {
-						can_en_passant = false;
-						break;
-					}
-
-					opponent_pieces >>= (squares_to_skip + 1);
-					square++;
-				}
-
 				// Add move if it won't leave the player's king under attack
-				if (can_en_passant) this->addMove(en_passant, pawn_location, opponent.locations.en_passant_target);
+				if (isEnPassantSafe(player, opponent, pawn_location)) this->addMove(en_passant, pawn_location, opponent.locations.en_passant_target);
 			}
 		}
 
@@ -196,7 +196,7 @@ void Moves::generateMoves(const Player& player, const Player& opponent) {
 		if (!player.isPinned(knight_location)) {
 			for (const short move : magic_bitboards.knight_moves[knight_location]) {
 				short final_square = getFinalSquare(move);
-				if ((1LL << final_square) & player.bitboards.friendly_pieces) continue;
+				if (!((1LL << final_square) & targets)) continue;
 				if (!canMove(is_in_check, final_square, player.bitboards.squares_to_uncheck)) continue;
 
 				this->addMove(knight_move | move);
@@ -216,7 +216,7 @@ void Moves::generateMoves(const Player& player, const Player& opponent) {
 		bool is_pinned = player.isPinned(bishop_location);
 
 		unsigned long long bitboard_attacks = slidingMoves(magic_bitboards.bishops_magic_bitboards[bishop_location], player.bitboards.all_pieces);
-		bitboard_attacks &= (~player.bitboards.friendly_pieces);
+		bitboard_attacks &= targets;
 		if (is_pinned) bitboard_attacks &= player.pins[bishop_location].squares_to_unpin;
 
 		addMovesFromAttacksBitboard(bishop_location, is_in_check, player.bitboards.squares_to_uncheck, bitboard_attacks, bishop_move, this);
@@ -234,7 +234,7 @@ void Moves::generateMoves(const Player& player, const Player& opponent) {
 		bool is_pinned = player.isPinned(rook_location);
 
 		unsigned long long bitboard_attacks = slidingMoves(magic_bitboards.rooks_magic_bitboards[rook_location], player.bitboards.all_pieces);
-		bitboard_attacks &= (~player.bitboards.friendly_pieces);
+		bitboard_attacks &= targets;
 		if (is_pinned) bitboard_attacks &= player.pins[rook_location].squares_to_unpin;
 
 		addMovesFromAttacksBitboard(rook_location, is_in_check, player.bitboards.squares_to_uncheck, bitboard_attacks, rook_move, this);
@@ -253,7 +253,7 @@ void Moves::generateMoves(const Player& player, const Player& opponent) {
 
 		unsigned long long bitboard_attacks = slidingMoves(magic_bitboards.bishops_magic_bitboards[queen_location], player.bitboards.all_pieces);
 		bitboard_attacks |= slidingMoves(magic_bitboards.rooks_magic_bitboards[queen_location], player.bitboards.all_pieces);
-		bitboard_attacks &= (~player.bitboards.friendly_pieces);
+		bitboard_attacks &= targets;
 		if (is_pinned) bitboard_attacks &= player.pins[queen_location].squares_to_unpin;
 
 		addMovesFromAttacksBitboard(queen_location, is_in_check, player.bitboards.squares_to_uncheck, bitboard_attacks, queen_move, this);
@@ -263,7 +263,7 @@ void Moves::generateMoves(const Player& player, const Player& opponent) {
 	}
 
 	// Castle
-	if (!is_in_check) {
+	if (generate_quiets && !is_in_check) {
 		unsigned long long mask_king_side = player.is_white ? castle_king_side_white_mask : castle_king_side_black_mask;
 		unsigned long long mask_queen_side_pieces = player.is_white ? castle_queen_side_white_pieces_mask : castle_queen_side_black_pieces_mask;
 		unsigned long long mask_queen_side_attacks = player.is_white ? castle_queen_side_white_attacks_mask : castle_queen_side_black_attacks_mask;
@@ -279,6 +279,7 @@ void Moves::generateMoves(const Player& player, const Player& opponent) {
 }
 
 void Moves::generateCaptures(Player& player, const Player& opponent) {
+	updatePins(player, opponent);
 	player.bitboards.attacks = 0;
 	unsigned long long opponent_pieces = opponent.bitboards.friendly_pieces;
 	if (player.bitboards.king & opponent.bitboards.attacks) opponent_pieces &= player.bitboards.squares_to_uncheck;
@@ -438,7 +439,8 @@ bool Moves::isMoveLegal (unsigned short move) const {
 	return false;
 }
 
-void Moves::orderMoves(const Player& player, const Player& opponent, const Entry* tt_entry, const std::array<unsigned short, 2>* killer_moves_at_ply) {
+void Moves::orderMoves(const Player& player, const Player& opponent, const Entry* tt_entry, const std::array<unsigned short, 2>* killer_moves_at_ply, 
+					   const HistoryTable& history_table) {
 	/*
 		Order of moves:
 			1. Move from TT if any
@@ -563,6 +565,9 @@ void Moves::orderMoves(const Player& player, const Player& opponent, const Entry
 	num_moves_left = num_moves;
 }
 
+// Fastest version supported by the CPU, picked once at startup
+static const BestMoveIndexFn best_move_index = selectBestMoveIndex();
+
 unsigned short Moves::getNextOrderedMove() {
 	if (num_moves_left == 0) return 0;
 	num_moves_left--;
@@ -573,66 +578,7 @@ unsigned short Moves::getNextOrderedMove() {
 		return moves[0];
 	}
 
-	__m256i scores_registers[8];
-	
-	scores_registers[0] = _mm256_load_si256((__m256i*) & scores[0]);
-	__m256i max_values;
-
-	if (num_moves > 16) {
-		int num_registers = (num_moves > 64) ? 8 : ((num_moves > 32) ? 4 : 2);
-
-		for (int i = 1; i < num_registers; i++) 
-			scores_registers[i] = _mm256_load_si256((__m256i*) & scores[i * 16]);
-
-		while (num_registers > 2) {
-			num_registers /= 2;
-
-			for (int i = 0; i < num_registers; i++) {
-				scores_registers[i] = _mm256_max_epu16(scores_registers[2 * i], scores_registers[2 * i + 1]);
-			}
-		}
-
-		max_values = _mm256_max_epu16(scores_registers[0], scores_registers[1]);
-	}
-	else {
-		max_values = scores_registers[0];
-	}
-
-	__m256i max_values_low  = _mm256_cvtepu16_epi32(_mm256_castsi256_si128(max_values));
-	__m256i max_values_high = _mm256_cvtepu16_epi32(_mm256_extracti128_si256(max_values, 1));
-
-	//alignas(64) constexpr int a[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
-	alignas(64) constexpr int a[16] = {15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0};
-
-	max_values_low  = _mm256_add_epi32(_mm256_slli_epi32(max_values_low , 4), _mm256_load_si256((__m256i*) a));
-	max_values_high = _mm256_add_epi32(_mm256_slli_epi32(max_values_high, 4), _mm256_load_si256((__m256i*) &a[8]));
-
-	max_values = _mm256_max_epi32(max_values_low, max_values_high);
-	
-	__m128i max_values_lo = _mm256_castsi256_si128(max_values);
-	__m128i max_values_hi = _mm256_extracti128_si256(max_values, 1);
-
-	__m128i max_values_4 = _mm_max_epi32(max_values_lo, max_values_hi);
-	
-	alignas(64) int b[4];
-	_mm_store_si128((__m128i *) b, max_values_4);
-
-	int max_1 = (b[0] > b[1]) ? b[0] : b[1];
-	int max_2 = (b[2] > b[3]) ? b[2] : b[3];
-
-	int max_score = (max_1 > max_2) ? max_1 : max_2;
-	int idx = (~max_score & 0b1111) + (~max_score & 0b1110000);
-
-	if (num_moves > 128) {
-		unsigned short next_max = scores[idx];
-
-		for (int i = 128; i < num_moves; i++) {
-			if (scores[i] > next_max) {
-				next_max = scores[i];
-				idx = i;
-			}
-		}
-	}
+	int idx = best_move_index(scores, num_moves);
 
 	scores[idx] = 0;
 	return moves[idx];
@@ -644,56 +590,26 @@ AttacksInfo generateAttacksInfo(bool is_white, const BitBoards& bitboards, unsig
 	unsigned long long opponent_squares_to_uncheck = 0;
 	unsigned long long opponent_king = (opponent_king_location < 64) ? (1LL << opponent_king_location) : 0;
 
-	// Pawn moves
-	short capture_right = is_white ? 9 : -9;
-	short capture_left = is_white ? 7 : -7;
-	short right_edge = is_white ? 7 : 0;
-	short left_edge = is_white ? 0 : 7;
-
-	unsigned long long cp_pawns_bitboard = bitboards.pawns;
-	location pawn_location = 0;
-	while (cp_pawns_bitboard != 0 && pawn_location <= 63) {
-		int squares_to_skip = std::countr_zero(cp_pawns_bitboard);
-		pawn_location += squares_to_skip;
-		short file = pawn_location % 8;
-		unsigned long long pawn_attacks = 0;
-
-		// If pawn can capture to at its right
-		if (file != right_edge) {
-			pawn_attacks |= (1LL << (pawn_location + capture_right));
-		}
-
-		// If pawn can capture to at its left
-		if (file != left_edge) {
-			pawn_attacks |= (1LL << (pawn_location + capture_left));
-		}
-
-		if (pawn_attacks & opponent_king) {
-			opponent_squares_to_uncheck = (1LL << pawn_location);
-		}
-
-		attacks_bitboard |= pawn_attacks;
+	// Pawn moves, all pawns at once. A pawn checks the king if a pawn of the opponent on the king's square would attack it
+	attacks_bitboard |= pawnAttacks(is_white, bitboards.pawns);
 
-		cp_pawns_bitboard >>= (squares_to_skip + 1);
-		pawn_location++;
+	unsigned long long checking_pawn = pawnAttacks(!is_white, opponent_king) & bitboards.pawns;
+	if (checking_pawn) {
+		opponent_squares_to_uncheck = checking_pawn;
 	}
 
 	// Knight moves
 	unsigned long long cp_knights_bitboard = bitboards.knights;
-	location knight_location = 0;
-	while (cp_knights_bitboard != 0 && knight_location <= 63) {
-		int squares_to_skip = std::countr_zero(cp_knights_bitboard);
-		knight_location += squares_to_skip;
-
-		unsigned long long knight_attacks = magic_bitboards.knights_attacks_array[knight_location];
-		attacks_bitboard |= knight_attacks;
+	while (cp_knights_bitboard) {
+		attacks_bitboard |= magic_bitboards.knights_attacks_array[std::countr_zero(cp_knights_bitboard)];
+		cp_knights_bitboard &= cp_knights_bitboard - 1;
+	}
 
-		if (knight_attacks & opponent_king) {
-			opponent_squares_to_uncheck = (1LL << knight_location);
+	if (opponent_king) {
+		unsigned long long checking_knight = magic_bitboards.knights_attacks_array[opponent_king_location] & bitboards.knights;
+		if (checking_knight) {
+			opponent_squares_to_uncheck = checking_knight;
 		}
-
-		cp_knights_bitboard >>= (squares_to_skip + 1);
-		knight_location++;
 	}
 
 	// Bishop moves
@@ -796,8 +712,21 @@ AttacksInfo generateAttacksInfo(bool is_white, const BitBoards& bitboards, unsig
 }
 
 inline unsigned long long slidingMoves(const MagicBitboard& magic_bitboard, unsigned long long pieces) {
+#ifdef USE_PEXT
+	return magic_bitboard.ptr_attacks_array[_pext_u64(pieces, ~magic_bitboard.mask)];
+#else
 	int index = ((pieces | magic_bitboard.mask) * magic_bitboard.magic_number) >> magic_bitboard.num_shifts;
 	return magic_bitboard.ptr_attacks_array[index];
+#endif
+}
+
+// Squares attacked by the pawns, pawns on the first and last files (a and h) don't capture across the edge of the board
+inline unsigned long long pawnAttacks(bool is_white, unsigned long long pawns) {
+	constexpr unsigned long long file_a = 0x0101010101010101;
+	constexpr unsigned long long file_h = 0x8080808080808080;
+
+	if (is_white) return ((pawns & ~file_h) << 9) | ((pawns & ~file_a) << 7);
+	return ((pawns & ~file_a) >> 9) | ((pawns & ~file_h) >> 7);
 }
 
 inline void addMovesFromAttacksBitboard(location start_square, bool is_in_check, unsigned long long squares_to_uncheck, 
@@ -837,7 +766,10 @@ inline int getPieceValue(const Player& player, location square) {
 	return 900; // Queen
 }
 
-void setPins(Player& player, Player& opponent) {
+void nextMoveId(Player& player, Player& opponent) {
+	player.move_id++;
+	opponent.move_id++;
+
 	if (player.move_id == 0) { // Reset pins if moves id overflowed
 		for (Pin& pin : player.pins) {
 			pin.id_move_pinned = 0;
@@ -849,50 +781,33 @@ void setPins(Player& player, Player& opponent) {
 
 		player.move_id = 1;
 		opponent.move_id = 1;
+		player.pins_move_id = 0;
+		opponent.pins_move_id = 0;
 	}
+}
 
-	// Pins by bishops
-	unsigned long long cp_bishops_bitboard = opponent.bitboards.bishops;
-	location bishop_location = 0;
-	while (cp_bishops_bitboard != 0 && bishop_location <= 63) {
-		int squares_to_skip = std::countr_zero(cp_bishops_bitboard);
-		bishop_location += squares_to_skip;
+void setPins(const Player& player, const Player& opponent) {
+	player.pins_move_id = player.move_id;
 
-		setPin(player, opponent, bishop_location, true);
+	// Only sliders on the same diagonal or line as the king (on an empty board) can pin a piece
+	location king_location = player.locations.king;
+	unsigned long long diagonal_pinners = (opponent.bitboards.bishops | opponent.bitboards.queens) &
+										  slidingMoves(magic_bitboards.bishops_magic_bitboards[king_location], 0);
+	unsigned long long line_pinners = (opponent.bitboards.rooks | opponent.bitboards.queens) &
+									  slidingMoves(magic_bitboards.rooks_magic_bitboards[king_location], 0);
 
-		cp_bishops_bitboard >>= (squares_to_skip + 1);
-		bishop_location++;
+	while (diagonal_pinners) {
+		setPin(player, opponent, std::countr_zero(diagonal_pinners), true);
+		diagonal_pinners &= diagonal_pinners - 1;
 	}
 
-	// Pins by rooks
-	unsigned long long cp_rooks_bitboard = opponent.bitboards.rooks;
-	location rook_location = 0;
-	while (cp_rooks_bitboard != 0 && rook_location <= 63) {
-		int squares_to_skip = std::countr_zero(cp_rooks_bitboard);
-		rook_location += squares_to_skip;
-
-		setPin(player, opponent, rook_location, false);
-
-		cp_rooks_bitboard >>= (squares_to_skip + 1);
-		rook_location++;
-	}
-
-	// Pins by queens
-	unsigned long long cp_queens_bitboard = opponent.bitboards.queens;
-	location queen_location = 0;
-	while (cp_queens_bitboard != 0 && queen_location <= 63) {
-		int squares_to_skip = std::countr_zero(cp_queens_bitboard);
-		queen_location += squares_to_skip;
-
-		setPin(player, opponent, queen_location, true);
-		setPin(player, opponent, queen_location, false);
-
-		cp_queens_bitboard >>= (squares_to_skip + 1);
-		queen_location++;
+	while (line_pinners) {
+		setPin(player, opponent, std::countr_zero(line_pinners), false);
+		line_pinners &= line_pinners - 1;
 	}
 }
 
-void setPin(Player& player, const Player& opponent, location piece_location, bool is_pin_diagonal) {
+void setPin(const Player& player, const Player& opponent, location piece_location, bool is_pin_diagonal) {
 	unsigned long long squares_to_uncheck;
 	if (is_pin_diagonal) squares_to_uncheck = squaresToUncheckBishop(player.locations.king, piece_location);
 	else squares_to_uncheck = squaresToUncheckRook(player.locations.king, piece_location);
@@ -916,6 +831,162 @@ void setPin(Player& player, const Player& opponent, location piece_location, boo
 	}
 }
 
+// Checks if capturing en passant with the pawn won't leave the player's king in check, since two pieces leave the same rank
+static bool isEnPassantSafe(const Player& player, const Player& opponent, location pawn_location) {
+	short move_one_square = player.is_white ? 8 : -8;
+
+	// Make en passant move
+	location location_pawn_captured = opponent.locations.en_passant_target - move_one_square;
+	unsigned long long all_pieces = opponent.bitboards.all_pieces ^ (1LL << pawn_location);
+	all_pieces ^= (1LL << location_pawn_captured);
+	all_pieces |= (1LL << opponent.locations.en_passant_target);
+	
+	// Check if en passant wont leave king in check
+	unsigned long long bishops_and_queens = opponent.bitboards.bishops | opponent.bitboards.queens;
+	unsigned long long rooks_and_queens   = opponent.bitboards.rooks   | opponent.bitboards.queens;
+	unsigned long long opponent_pieces    = bishops_and_queens         | rooks_and_queens;
+
+	int square = 0;
+	while (opponent_pieces != 0 && square <= 63) {
+		int squares_to_skip = std::countr_zero(opponent_pieces);
+		square += squares_to_skip;
+
+		unsigned long long bitboard_square = (1LL << square);
+		unsigned long long squares_to_uncheck = 0;
+
+		if (bitboard_square & bishops_and_queens) squares_to_uncheck |= squaresToUncheckBishop(player.locations.king, square);
+		if (bitboard_square & rooks_and_queens) squares_to_uncheck |= squaresToUncheckRook(player.locations.king, square);
+
+		if (((squares_to_uncheck ^ bitboard_square) & all_pieces) == 0) return false;
+
+		opponent_pieces >>= (squares_to_skip + 1);
+		square++;
+	}
+
+	return true;
+}
+
+bool isLegal(unsigned short move, const Player& player, const Player& opponent) {
+	if (!isPseudoLegal(move, player)) return false;
+
+	unsigned short flag = getMoveFlag(move);
+	location start_square = getStartSquare(move);
+	location final_square = getFinalSquare(move);
+	unsigned long long final_square_bitboard = 1LL << final_square;
+	bool is_in_check = opponent.bitboards.attacks & player.bitboards.king;
+
+	switch (flag) {
+	case king_move:
+		return (magic_bitboards.king_attacks_array[start_square] & final_square_bitboard) && !(opponent.bitboards.attacks & final_square_bitboard);
+
+	case castle_king_side: {
+		unsigned long long mask_king_side = player.is_white ? castle_king_side_white_mask : castle_king_side_black_mask;
+
+		return !is_in_check && player.can_castle_king_side && final_square == start_square + 2 && 
+			   !(player.bitboards.all_pieces & mask_king_side) && !(opponent.bitboards.attacks & mask_king_side);
+	}
+
+	case castle_queen_side: {
+		unsigned long long mask_queen_side_pieces = player.is_white ? castle_queen_side_white_pieces_mask : castle_queen_side_black_pieces_mask;
+		unsigned long long mask_queen_side_attacks = player.is_white ? castle_queen_side_white_attacks_mask : castle_queen_side_black_attacks_mask;
+
+		return !is_in_check && player.can_castle_queen_side && final_square == start_square - 2 &&
+			   !(player.bitboards.all_pieces & mask_queen_side_pieces) && !(opponent.bitboards.attacks & mask_queen_side_attacks);
+	}
+
+	default:
+		break;
+	}
+
+	// If double check only moves are king moves
+	if (is_in_check && !player.bitboards.squares_to_uncheck) return false;
+
+	updatePins(player, opponent);
+	bool is_pinned = player.isPinned(start_square);
+	unsigned long long attacks;
+
+	switch (flag) {
+	case knight_move:
+		if (is_pinned) return false;
+		attacks = magic_bitboards.knights_attacks_array[start_square];
+		break;
+
+	case bishop_move:
+		attacks = slidingMoves(magic_bitboards.bishops_magic_bitboards[start_square], player.bitboards.all_pieces);
+		break;
+
+	case rook_move:
+		attacks = slidingMoves(magic_bitboards.rooks_magic_bitboards[start_square], player.bitboards.all_pieces);
+		break;
+
+	case queen_move:
+		attacks = slidingMoves(magic_bitboards.bishops_magic_bitboards[start_square], player.bitboards.all_pieces);
+		attacks |= slidingMoves(magic_bitboards.rooks_magic_bitboards[start_square], player.bitboards.all_pieces);
+		break;
+
+	default: // Pawn moves
+		return isPawnMoveLegal(move, player, opponent, is_in_check);
+	}
+
+	if (is_pinned) attacks &= player.pins[start_square].squares_to_unpin;
+
+	return (attacks & final_square_bitboard) && canMove(is_in_check, final_square, player.bitboards.squares_to_uncheck);
+}
+
+// Same rules as the pawn moves in generateMoves
+static bool isPawnMoveLegal(unsigned short move, const Player& player, const Player& opponent, bool is_in_check) {
+	unsigned short flag = getMoveFlag(move);
+	location start_square = getStartSquare(move);
+	location final_square = getFinalSquare(move);
+
+	short move_one_square = player.is_white ? 8 : -8;
+	short capture_right = player.is_white ? 9 : -9;
+	short capture_left = player.is_white ? 7 : -7;
+	short right_edge = player.is_white ? 7 : 0;
+	short left_edge = player.is_white ? 0 : 7;
+	short location_unmoved_a_pawn = player.is_white ? 8 : 48;
+
+	short file = start_square % 8;
+	short distance = final_square - start_square;
+	bool is_pinned = player.isPinned(start_square);
+	const Pin& pin = player.pins[start_square];
+
+	if (flag == en_passant) {
+		if (opponent.locations.en_passant_target == 0 || final_square != opponent.locations.en_passant_target) return false;
+		if (!((distance == capture_right && file != right_edge) || (distance == capture_left && file != left_edge))) return false;
+		if (is_pinned && !pin.is_pin_diagonal) return false;
+
+		return isEnPassantSafe(player, opponent, start_square);
+	}
+
+	// Only promotions move to the last rank
+	if (isPromotion(move) != (final_square >= 56 || final_square <= 7)) return false;
+
+	// Pawn moves foward
+	if (distance == move_one_square || flag == pawn_move_two_squares) {
+		location new_location = start_square + move_one_square;
+		if (player.bitboards.all_pieces & (1LL << new_location)) return false;
+		if (is_pinned && (pin.is_pin_diagonal || !((1LL << new_location) & pin.squares_to_unpin))) return false;
+
+		if (flag == pawn_move_two_squares) {
+			short distance_unmoved = start_square - location_unmoved_a_pawn;
+			if (distance != 2 * move_one_square || distance_unmoved > 7 || distance_unmoved < 0) return false;
+			if (player.bitboards.all_pieces & (1LL << final_square)) return false;
+		}
+
+		return canMove(is_in_check, final_square, player.bitboards.squares_to_uncheck);
+	}
+
+	// Pawn captures
+	if (!((distance == capture_right && file != right_edge) || (distance == capture_left && file != left_edge))) return false;
+	if (!((1LL << final_square) & opponent.bitboards.friendly_pieces)) return false;
+
+	if (!is_pinned) return canMove(is_in_check, final_square, player.bitboards.squares_to_uncheck);
+
+	// Pinned pawn can only capture its pinner
+	return pin.is_pin_diagonal && !is_in_check && final_square == pin.location_pinner;
+}
+
 unsigned short Moves::parseMove(std::string& move_str) {
 	unsigned short move = 0;
 
@@ -7,6 +7,7 @@
 #include <string>
 
 struct Entry;
+struct HistoryTable;
 
 constexpr int max_num_moves = 218;
 
@@ -38,6 +39,9 @@ static_assert((promotion_bishop & promotion_mask) == promotion);
 static_assert((promotion_rook & promotion_mask) == promotion);
 static_assert((promotion_queen & promotion_mask) == promotion);
 
+// Moves generated by generateMoves, captures also include promotions and en passants
+enum MoveType { AllMoves, Captures, Quiets };
+
 struct AttacksInfo {
 	unsigned long long attacks_bitboard;
 	unsigned long long opponent_squares_to_uncheck;
@@ -52,6 +56,9 @@ class Moves {
 	alignas(64) unsigned short scores[max_num_moves] = {};
 	int num_moves_left = 0;
 
+	template <MoveType move_type>
+	void generateMovesOfType(const Player& player, const Player& opponent);
+
 public:
 	short num_moves = 0;
 
@@ -72,7 +79,7 @@ public:
 	inline unsigned short operator[] (int i) const { return moves[i]; }
 	inline unsigned short& operator[] (int i) { return moves[i]; }
 
-	void generateMoves(const Player& player, const Player& opponent);
+	void generateMoves(const Player& player, const Player& opponent, MoveType move_type = AllMoves);
 
 	/* Updates player's attack bitboard, does not include king attacks to squares that 
 	are defedend or attacks of pinned pieces that would leave the king in check if played */
@@ -81,7 +88,8 @@ public:
 	unsigned short parseMove(std::string& move_str);
 	bool isMoveLegal (unsigned short move) const;
 
-	void orderMoves(const Player& player, const Player& opponent, const Entry* tt_entry, const std::array<unsigned short, 2>* killer_moves_at_ply);
+	void orderMoves(const Player& player, const Player& opponent, const Entry* tt_entry, const std::array<unsigned short, 2>* killer_moves_at_ply, 
+					const HistoryTable& history_table);
 	unsigned short getNextOrderedMove();
 };
 
@@ -95,7 +103,15 @@ inline unsigned long long generateAttacksBitBoard(bool is_white, const BitBoards
 	return generateAttacksInfo(is_white, bitboards, all_pieces, player_king_location, 64).attacks_bitboard;
 }
 
-void setPins(Player& player, Player& opponent);
+void setPins(const Player& player, const Player& opponent);
+
+// Computes the pins of the player if they were not computed since the last move made or unmade
+inline void updatePins(const Player& player, const Player& opponent) {
+	if (player.pins_move_id != player.move_id) setPins(player, opponent);
+}
+
+// Called when a move is made or unmade, so that the pins of both players are recomputed when they are next needed
+void nextMoveId(Player& player, Player& opponent);
 
 inline bool isPromotion(unsigned short move) { return ((move & promotion_mask) == promotion); }
 inline unsigned short getMoveFlag(unsigned short move) { return move & move_flag_mask; }
@@ -107,4 +123,7 @@ PieceType getPieceType(unsigned short move);
 
 bool isPseudoLegal(unsigned short move, const Player& player);
 
+// Same as checking if generateMoves generates the move, without generating the moves of the position.
+bool isLegal(unsigned short move, const Player& player, const Player& opponent);
+
 std::string moveToStr(unsigned short move);
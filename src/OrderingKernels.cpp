@@ -0,0 +1,14 @@
+#include "OrderingKernels.h"
+#include "CpuFeatures.h"
+
+BestMoveIndexFn selectBestMoveIndex() {
+#ifdef PORTABLE_KERNELS
+	const CpuFeatures& cpu = cpuFeatures();
+
+	if (cpu.avx2)  return bestMoveIndexAVX2;
+	if (cpu.sse41) return bestMoveIndexSSE41;
+	return bestMoveIndexScalar;
+#else
+	return bestMoveIndexAVX2;
+#endif
+}
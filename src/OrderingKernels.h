@@ -0,0 +1,19 @@
+#pragma once
+
+/*
+	Versions of the search for the best scored move used by Moves::getNextOrderedMove, one for each instruction set,
+	the fastest one supported by the CPU is picked at runtime. Each version is in its own translation unit, compiled
+	with the flags of its instruction set, scalar and SSE4.1 versions are only built with PORTABLE_KERNELS.
+
+	All versions return the index of the highest score in [0, num_moves), scores must be aligned to 32 bytes and
+	have at least 128 elements, since the SIMD versions read blocks of 16 scores past num_moves (which are ignored
+	by the scoring scheme of orderMoves, as the low 3 bits of the score encode the block of the move).
+*/
+using BestMoveIndexFn = int (*)(const unsigned short* scores, int num_moves);
+
+// Fastest version supported by the CPU
+BestMoveIndexFn selectBestMoveIndex();
+
+int bestMoveIndexScalar(const unsigned short* scores, int num_moves);
+int bestMoveIndexSSE41(const unsigned short* scores, int num_moves);
+int bestMoveIndexAVX2(const unsigned short* scores, int num_moves);
@@ -0,0 +1,42 @@
+#include "OrderingKernels.h"
+#include <bit>
+#include <immintrin.h>
+
+int bestMoveIndexSSE41(const unsigned short* scores, int num_moves) {
+	// Same layout as the AVX2 version, blocks of 16 scores split in a low and a high half
+	int num_blocks = (num_moves > 64) ? 8 : ((num_moves > 32) ? 4 : ((num_moves > 16) ? 2 : 1));
+
+	__m128i max_low  = _mm_load_si128((__m128i*) &scores[0]);
+	__m128i max_high = _mm_load_si128((__m128i*) &scores[8]);
+
+	for (int i = 1; i < num_blocks; i++) {
+		max_low  = _mm_max_epu16(max_low,  _mm_load_si128((__m128i*) &scores[i * 16 + 0]));
+		max_high = _mm_max_epu16(max_high, _mm_load_si128((__m128i*) &scores[i * 16 + 8]));
+	}
+
+	// minpos finds the minimum u16, so the scores are inverted to find the maximum
+	const __m128i all_ones = _mm_set1_epi16(-1);
+	const __m128i inverted = _mm_xor_si128(_mm_max_epu16(max_low, max_high), all_ones);
+	const unsigned short max_score = ~_mm_cvtsi128_si32(_mm_minpos_epu16(inverted));
+
+	// Lane of the max score (first one in case of ties), block is encoded in the low 3 bits of the score
+	const __m128i max_scores = _mm_set1_epi16(max_score);
+	int mask_low  = _mm_movemask_epi8(_mm_cmpeq_epi16(max_low,  max_scores));
+	int mask_high = _mm_movemask_epi8(_mm_cmpeq_epi16(max_high, max_scores));
+
+	int lane = mask_low ? (std::countr_zero((unsigned) mask_low) / 2) : (8 + std::countr_zero((unsigned) mask_high) / 2);
+	int idx = lane + 16 * (7 - (max_score & 0b111));
+
+	if (num_moves > 128) {
+		unsigned short next_max = scores[idx];
+
+		for (int i = 128; i < num_moves; i++) {
+			if (scores[i] > next_max) {
+				next_max = scores[i];
+				idx = i;
+			}
+		}
+	}
+
+	return idx;
+}
@@ -0,0 +1,12 @@
+#include "OrderingKernels.h"
+
+int bestMoveIndexScalar(const unsigned short* scores, int num_moves) {
+	int idx = 0;
+
+	for (int i = 1; i < num_moves; i++) {
+		if (scores[i] > scores[idx])
+			idx = i;
+	}
+
+	return idx;
+}
@@ -6,11 +6,58 @@
 #include "Player.h"
 #include "Position.h"
 #include "Zobrist.h"
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <functional>
 #include <iostream>
+#include <thread>
+#include <vector>
 
-static unsigned long long Perftr(int depth, Player& player, Player& opponent, Moves& moves);
+// Subtree of the parallel perft, reached by playing the root move and then the reply
+struct PerftTask {
+	int index_root_move;
+	unsigned short root_move, reply;
+	unsigned long long nodes = 0;
+};
+
+static unsigned long long Perftr(int depth, Player& player, Player& opponent, Moves& moves, uint64_t hash, PerftTable* table);
+static unsigned long long ParallelPerft(int depth, const Player& player, const Player& opponent, int num_threads, PerftTable* table, std::vector<unsigned long long>& nodes_root_moves);
+static void perftWorker(int depth, const Player& player, const Player& opponent, PerftTable* table, std::vector<PerftTask>& tasks, std::atomic_int& next_task);
+
+PerftTable::PerftTable(size_t size_mb) {
+	assert(size_mb > 0, "size_mb must be positive.");
+	size_t max_entries = std::bit_floor(size_mb * 1024 * 1024 / sizeof(PerftEntry));
+	table = std::make_unique<PerftEntry[]>(max_entries);
+	index_mask = max_entries - 1;
+}
+
+bool PerftTable::get(uint64_t hash, int depth, unsigned long long& nodes) const {
+	const PerftEntry& entry = table[hash & index_mask];
+	uint64_t key  = entry.key.load(std::memory_order_relaxed);
+	uint64_t data = entry.data.load(std::memory_order_relaxed);
+
+	if ((key ^ data) != hash || (data & 0xff) != (uint64_t) depth) return false;
+
+	nodes = data >> 8;
+	return true;
+}
+
+// Always replaces, the entry being stored is the most likely to be needed again
+void PerftTable::store(uint64_t hash, int depth, unsigned long long nodes) {
+	PerftEntry& entry = table[hash & index_mask];
+	uint64_t data = (nodes << 8) | (uint64_t) depth;
+
+	entry.key.store(hash ^ data, std::memory_order_relaxed);
+	entry.data.store(data, std::memory_order_relaxed);
+}
+
+unsigned long long Perft(int depth, Player& player, Player& opponent, int num_threads, PerftTable* table) {
+	if (num_threads > 1 && depth >= 3) {
+		std::vector<unsigned long long> nodes_root_moves;
+		return ParallelPerft(depth, player, opponent, num_threads, table, nodes_root_moves);
+	}
 
-unsigned long long Perft(int depth, Player& player, Player& opponent) {
 	/*
 	Perftr won't revert back changes in attacks and squares_to_uncheck bitboards, which is problematic if it
 	is called multiples times on the same position, since it won't leave the position as it was before, this
@@ -22,7 +69,8 @@ unsigned long long Perft(int depth, Player& player, Player& opponent) {
 	unsigned long long attacks = opponent.bitboards.attacks;
 	unsigned long long squares_to_uncheck = player.bitboards.squares_to_uncheck;
 
-	unsigned long long results = Perftr(depth, player, opponent, moves);
+	uint64_t hash = (table != nullptr) ? zobrist_keys.positionToHash(player, opponent) : 0;
+	unsigned long long results = Perftr(depth, player, opponent, moves, hash, table);
 
 	opponent.bitboards.attacks = attacks;
 	player.bitboards.squares_to_uncheck = squares_to_uncheck;
@@ -30,16 +78,23 @@ unsigned long long Perft(int depth, Player& player, Player& opponent) {
 	return results;
 }
 
-static unsigned long long Perftr(int depth, Player& player, Player& opponent, Moves& moves) {
+/*
+	The hash is updated by makeMove even if no table is used, so carrying it costs nothing. Positions at depth 1
+	are not looked up, generating their moves for bulk counting is about as fast as a probe.
+*/
+static unsigned long long Perftr(int depth, Player& player, Player& opponent, Moves& moves, uint64_t hash, PerftTable* table) {
 	if (depth == 0) return 1;
-	
+
+	unsigned long long nodes;
+	if (table != nullptr && depth >= 2 && table->get(hash, depth, nodes)) return nodes;
+
 	moves.generateMoves(player, opponent);
 
 	// Bulk counting
 	if (depth == 1) return moves.num_moves;
 
 	Moves new_moves;
-	unsigned long long nodes = 0;
+	nodes = 0;
 
 	for (const unsigned short move : moves) {
 		/*
@@ -48,17 +103,32 @@ static unsigned long long Perftr(int depth, Player& player, Player& opponent, Mo
 			are alredy computed.
 		*/
 
-		MoveInfo move_info = makeMove(move, player, opponent, 0, false);
-		nodes += Perftr(depth - 1, opponent, player, new_moves);
-		unmakeMove(move, player, opponent, move_info, false);
+		MoveInfo move_info = makeMove(move, player, opponent, hash);
+		nodes += Perftr(depth - 1, opponent, player, new_moves, move_info.hash, table);
+		unmakeMove(move, player, opponent, move_info);
 	}
 
+	if (table != nullptr) table->store(hash, depth, nodes);
+
 	return nodes;
 }
 
-unsigned long long PerftDivide(int depth, Player& player, Player& opponent) {
+unsigned long long PerftDivide(int depth, Player& player, Player& opponent, int num_threads, PerftTable* table) {
 	unsigned long long nodes = 0;
 
+	if (num_threads > 1 && depth >= 3) {
+		Moves moves;
+		moves.generateMoves(player, opponent);
+
+		std::vector<unsigned long long> nodes_root_moves;
+		nodes = ParallelPerft(depth, player, opponent, num_threads, table, nodes_root_moves);
+
+		for (int i = 0; i < moves.num_moves; i++)
+			std::cout << locationToNotationSquare(getStartSquare(moves[i])) << locationToNotationSquare(getFinalSquare(moves[i])) << ": " << nodes_root_moves[i] << '\n';
+
+		return nodes;
+	}
+
 	unsigned long long attacks = opponent.bitboards.attacks;
 	unsigned long long squares_to_uncheck = player.bitboards.squares_to_uncheck;
 
@@ -67,11 +137,11 @@ unsigned long long PerftDivide(int depth, Player& player, Player& opponent) {
 
 	for (const unsigned short move : moves) {
 		std::cout << locationToNotationSquare((move >> 6) & 0x3f) << locationToNotationSquare(move & 0x3f);
-		MoveInfo move_info = makeMove(move, player, opponent, 0, false);
-		unsigned long long nodes_move = Perft(depth - 1, opponent, player);
+		MoveInfo move_info = makeMove(move, player, opponent, 0);
+		unsigned long long nodes_move = Perft(depth - 1, opponent, player, 1, table);
 		nodes += nodes_move;
 		std::cout << ": " << nodes_move << '\n';
-		unmakeMove(move, player, opponent, move_info, false);
+		unmakeMove(move, player, opponent, move_info);
 	}
 
 	opponent.bitboards.attacks = attacks;
@@ -79,3 +149,59 @@ unsigned long long PerftDivide(int depth, Player& player, Player& opponent) {
 
 	return nodes;
 }
+
+/*
+	The tree is split in one subtree for each pair of root move and reply, which are independent of each other, and
+	every thread takes the next subtree not yet taken from the shared list as soon as it finishes the previous one,
+	so threads that get smaller subtrees just search more of them. Each subtree is searched on copies of the players,
+	the position passed is never changed. The table, if any, is shared by all threads.
+*/
+static unsigned long long ParallelPerft(int depth, const Player& player, const Player& opponent, int num_threads, PerftTable* table, std::vector<unsigned long long>& nodes_root_moves) {
+	Player root_player = player, root_opponent = opponent;
+	std::vector<PerftTask> tasks;
+
+	Moves moves, replies;
+	moves.generateMoves(root_player, root_opponent);
+	nodes_root_moves.assign(moves.num_moves, 0);
+
+	for (int i = 0; i < moves.num_moves; i++) {
+		Player new_player = root_player, new_opponent = root_opponent;
+		makeMove(moves[i], new_player, new_opponent, 0);
+
+		replies.generateMoves(new_opponent, new_player);
+		for (const unsigned short reply : replies)
+			tasks.push_back({ i, moves[i], reply });
+	}
+
+	std::atomic_int next_task = 0;
+	std::vector<std::thread> threads;
+	threads.reserve(num_threads);
+
+	for (int i = 0; i < num_threads; i++)
+		threads.emplace_back(perftWorker, depth, std::cref(root_player), std::cref(root_opponent), table, std::ref(tasks), std::ref(next_task));
+
+	for (std::thread& thread : threads) thread.join();
+
+	unsigned long long nodes = 0;
+	for (const PerftTask& task : tasks) {
+		nodes_root_moves[task.index_root_move] += task.nodes;
+		nodes += task.nodes;
+	}
+
+	return nodes;
+}
+
+static void perftWorker(int depth, const Player& player, const Player& opponent, PerftTable* table, std::vector<PerftTask>& tasks, std::atomic_int& next_task) {
+	Moves moves;
+	uint64_t root_hash = (table != nullptr) ? zobrist_keys.positionToHash(player, opponent) : 0;
+
+	for (int i = next_task++; i < (int) tasks.size(); i = next_task++) {
+		PerftTask& task = tasks[i];
+		Player new_player = player, new_opponent = opponent;
+
+		uint64_t hash = makeMove(task.root_move, new_player, new_opponent, root_hash).hash;
+		hash = makeMove(task.reply, new_opponent, new_player, hash).hash;
+
+		task.nodes = Perftr(depth - 2, new_player, new_opponent, moves, hash, table);
+	}
+}
@@ -2,13 +2,41 @@
 #include "MagicBitboards.h"
 #include "Player.h"
 #include "Zobrist.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+/*
+	Node counts of the positions alredy searched by a hashed perft, for each hash and depth. It can be shared by the
+	threads of a parallel perft without locks, the hash stored in an entry is xored with its data (as in the transposition
+	table), so an entry torn by concurrent writes fails the hash check and is treated as a miss.
+	Counts don't depend on the root, so the same table can be reused for any number of perft calls.
+*/
+class PerftTable {
+	struct PerftEntry {
+		std::atomic<uint64_t> key  = 0; // hash ^ data
+		std::atomic<uint64_t> data = 0; // Node count in the upper 56 bits, depth in the lower 8 bits
+	};
+
+	std::unique_ptr<PerftEntry[]> table;
+	uint64_t index_mask = 0;
+
+public:
+	PerftTable(size_t size_mb);
+
+	bool get(uint64_t hash, int depth, unsigned long long& nodes) const;
+	void store(uint64_t hash, int depth, unsigned long long nodes);
+};
 
 /*
 	Used to test and measure performance of move generation function as well 
 	as make and unmake moves functions.
 	Ignores draws by repetition, 50 moves rule and insufficient material, terminal
 	nodes (checkmate or stalemate) are not counted, it uses bulk counting.
+	With more than one thread, subtrees of the position are searched in parallel (for depth 3 and above).
+	If a table is passed, the node counts of transpositions are taken from it instead of being searched again.
 */
-unsigned long long Perft(int depth, Player& player, Player& opponent);
+unsigned long long Perft(int depth, Player& player, Player& opponent, int num_threads=1, PerftTable* table=nullptr);
 
-unsigned long long PerftDivide(int depth, Player& player, Player& opponent);
+// Prints the number of positions after each move
+unsigned long long PerftDivide(int depth, Player& player, Player& opponent, int num_threads=1, PerftTable* table=nullptr);
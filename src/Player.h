@@ -11,7 +11,13 @@ public:
 	unsigned int move_id = 1;
 	BitBoards bitboards;
 	Locations locations;
-	std::array<Pin, 64> pins;
+
+	/*
+		Pins are only computed when the moves of the position are needed (see updatePins), since many positions of the
+		search are cut before that. They are a cache of the position, so they can be set from a const Player.
+	*/
+	mutable std::array<Pin, 64> pins;
+	mutable unsigned int pins_move_id = 0; // move id the pins were computed at
 
 	Player(bool is_white);
 	bool isPinned(location location) const;
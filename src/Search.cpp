@@ -6,113 +6,191 @@
 #include "MagicBitboards.h"
 #include "MakeMoves.h"
 #include "Moves.h"
+#include "MovePicker.h"
 #include "Player.h"
+#include "SearchContext.h"
 #include "TranspositionTable.h"
 #include "Zobrist.h"
 #include "EvaluateNNUE.h"
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <bit>
 #include <chrono>
 #include <climits>
+#include <condition_variable>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
 #include <thread>
 #include <vector>
 
-int Search(int depth, int alpha, int beta, Player& player, Player& opponent, HashPositions& positions, 
-           int half_moves, int num_pieces, std::vector<std::array<unsigned short, 2>>& killer_moves, 
-           bool reduced = false, bool used_null_move = false);
-int quiescenceSearch(int alpha, int beta, Player& player, Player& opponent, int num_pieces);
+int Search(SearchContext& context, int depth, int alpha, int beta, Player& player, Player& opponent, HashPositions& positions, 
+           int half_moves, int num_pieces, int ply, bool reduced = false, bool used_null_move = false);
+int quiescenceSearch(SearchContext& context, int alpha, int beta, Player& player, Player& opponent, unsigned long long hash, int num_pieces, int ply);
 bool nullMove(Player& player, Player& opponent);
 bool reduceMove(int mv_pos, unsigned short mv, int depth, const MoveInfo& mv_info, const Player& player, 
                 const Player& opponent, bool player_in_check, const std::array<unsigned short, 2>& killer_moves_at_ply);
 
-void repetition(Player& player, Player& opponent, const HashPositions& positions);
-bool deal_repetition(Player& player, Player& opponent, const HashPositions& positions, unsigned long long hash, unsigned long long repeated_position, Entry* entry);
-unsigned short getPonder(unsigned short best_move, Player& player, Player& opponent, unsigned long long hash);
+void repetition(SearchContext& context, Player& player, Player& opponent, const HashPositions& positions);
+bool deal_repetition(SearchContext& context, Player& player, Player& opponent, const HashPositions& positions, unsigned long long hash, unsigned long long repeated_position, const Entry& entry);
+unsigned short getPonder(SearchContext& context, unsigned short best_move, Player& player, Player& opponent, unsigned long long hash);
+std::vector<unsigned short> getPV(SearchContext& context, unsigned short best_move, int max_length, Player& player, Player& opponent, unsigned long long hash);
+void extendPV(SearchContext& context, std::vector<unsigned short>& pv, int max_length, Player& player, Player& opponent, unsigned long long hash, std::vector<unsigned long long>& hashes);
+void printInfo(SearchContext& context, const SearchResult& result, Player& player, Player& opponent, const HashPositions& positions);
+long long elapsedMs(const SearchContext& context);
 
-std::atomic_bool timed_out = false;
-int search_id = 0; // Only written by main thread, does not need to be atomic
+std::vector<std::thread> startHelpers(SearchContext& context, int max_depth, const Player& player, const Player& opponent, const HashPositions& positions, int half_moves);
+void stopHelpers(SearchContext& context, std::vector<std::thread>& helpers);
+void helperSearch(SearchContext& context, int helper_id, int max_depth, Player player, Player opponent, HashPositions positions, int half_moves);
 
-void stopSearch(int id) {
-    if (id == search_id) timed_out = true;
-}
-
-void FindBestMoveItrDeepening(std::chrono::milliseconds time, Player& player, Player& opponent, HashPositions& positions, int half_moves, SearchResult& result) {
+void FindBestMoveItrDeepening(SearchContext& context, std::chrono::milliseconds time, Player& player, Player& opponent, HashPositions& positions, int half_moves, SearchResult& result) {
     result = { 0, 0, 0, 0 };
 
-    // Set timer to search
-    search_id++;
-    timed_out = false;
-    std::thread timer([time]() {
-        std::this_thread::sleep_for(time);
-        stopSearch(search_id);
+    // Set timer to search, it is woken up early if the search finishes before the time ends
+    context.stop = false;
+    context.nodes = 0;
+    context.stats = SearchStats();
+    context.start_time = std::chrono::steady_clock::now();
+    std::mutex timer_mutex;
+    std::condition_variable timer_cv;
+    bool search_finished = false;
+    std::thread timer([&]() {
+        std::unique_lock lock(timer_mutex);
+        if (!timer_cv.wait_for(lock, time, [&]() { return search_finished; })) context.stop = true;
     });
 
     // Check for hallucinations of the engine if a position has alredy been repeated twice and principal variation leads to draw by repetition
-    repetition(player, opponent, positions);
+    repetition(context, player, opponent, positions);
+
+    std::vector<std::thread> helpers = startHelpers(context, INT_MAX, player, opponent, positions, half_moves);
 
     int depth = 1;
-    while (result.evaluation != checkmated_eval && result.evaluation != checkmate_eval && !timed_out) {
-        SearchResult r = FindBestMove(depth, player, opponent, positions, half_moves);
-        depth++;
+    while (result.evaluation != checkmated_eval && result.evaluation != checkmate_eval && !context.stop) {
+        SearchResult r = FindBestMove(context, depth, player, opponent, positions, half_moves);
+
+        // An exact TT hit at the root can give a deeper result, the depths it alredy covers are skipped
+        depth = std::max<int>(depth, r.depth) + 1;
         
         // Ignore result if search was canceled imediately, without being able to look at any moves
-        if (r.best_move != 0) result = r;
+        if (r.best_move != 0) {
+            result = r;
+            if (context.print_info) printInfo(context, result, player, opponent, positions);
+        }
     }
 
-    timer.detach();
+    stopHelpers(context, helpers);
+
+    {
+        std::lock_guard lock(timer_mutex);
+        search_finished = true;
+    }
+    timer_cv.notify_one();
+    timer.join();
 }
 
 
-void FindBestMoveItrDeepening(int depth, Player& player, Player& opponent, HashPositions& positions, int half_moves, SearchResult& result) {
+void FindBestMoveItrDeepening(SearchContext& context, int depth, Player& player, Player& opponent, HashPositions& positions, int half_moves, SearchResult& result) {
     result = { 0, 0, 0, 0 };
 
-    search_id++;
-    timed_out = false;
+    context.stop = false;
+    context.nodes = 0;
+    context.stats = SearchStats();
+    context.start_time = std::chrono::steady_clock::now();
 
     // Check for hallucinations of the engine if a position has alredy been repeated twice and principal variation leads to draw by repetition
-    repetition(player, opponent, positions);
+    repetition(context, player, opponent, positions);
+
+    std::vector<std::thread> helpers = startHelpers(context, depth, player, opponent, positions, half_moves);
 
     for (int i = 1; i <= depth; i++) {
-        SearchResult r = FindBestMove(i, player, opponent, positions, half_moves);
+        SearchResult r = FindBestMove(context, i, player, opponent, positions, half_moves);
+
+        // An exact TT hit at the root can give a deeper result, the depths it alredy covers are skipped
+        i = std::max<int>(i, r.depth);
         
         // Ignore result if search was canceled imediately, without being able to look at any moves
-        if (r.best_move != 0) result = r;
+        if (r.best_move != 0) {
+            result = r;
+            if (context.print_info) printInfo(context, result, player, opponent, positions);
+        }
 
-        if (result.evaluation == checkmated_eval || result.evaluation == checkmate_eval || timed_out) break;
+        if (result.evaluation == checkmated_eval || result.evaluation == checkmate_eval || context.stop) break;
     }
+
+    stopHelpers(context, helpers);
 }
 
 
-SearchResult FindBestMove(int depth, Player& player, Player& opponent, HashPositions& positions, int half_moves) {
+/*
+    Lazy SMP: helper threads search the same root position as the main thread, each one with its own copy of the
+    position and its own search context (NNUE accumulator, killer moves and history table), and only the transposition
+    table and the stop flag are shared. The contexts of the helpers are kept by the main context, so that their nodes
+    can be counted. Results of the helpers are never used directly, they fill the transposition
+    table with entries that the main thread will find, making its search faster. Odd helpers start one depth ahead so
+    that not every thread is searching the same depth at the same time.
+*/
+std::vector<std::thread> startHelpers(SearchContext& context, int max_depth, const Player& player, const Player& opponent, const HashPositions& positions, int half_moves) {
+    std::vector<std::thread> helpers;
+    helpers.reserve(context.num_threads - 1);
+    context.helpers.clear();
+
+    for (int i = 1; i < context.num_threads; i++) {
+        // Allocated on the heap, since the NNUE accumulator and history table are too big for the stack of a thread
+        context.helpers.push_back(std::make_unique<SearchContext>(context.tt, context.stop));
+        helpers.emplace_back(helperSearch, std::ref(*context.helpers.back()), i, max_depth, player, opponent, positions, half_moves);
+    }
+
+    return helpers;
+}
+
+void stopHelpers(SearchContext& context, std::vector<std::thread>& helpers) {
+    // Main thread finished its search, so the helpers can stop
+    context.stop = true;
+
+    for (std::thread& helper : helpers) helper.join();
+}
+
+void helperSearch(SearchContext& context, int helper_id, int max_depth, Player player, Player opponent, HashPositions positions, int half_moves) {
+    for (int depth = 1 + (helper_id % 2); depth <= max_depth && !context.stop; depth++) {
+        SearchResult r = FindBestMove(context, depth, player, opponent, positions, half_moves);
+
+        if (r.evaluation == checkmated_eval || r.evaluation == checkmate_eval) break;
+    }
+}
+
+
+SearchResult FindBestMove(SearchContext& context, int depth, Player& player, Player& opponent, HashPositions& positions, int half_moves) {
 
     int num_pieces = std::popcount(player.bitboards.all_pieces);
+    context.seldepth = 0;
 
     unsigned short best_move = 0;
     unsigned short ponder;
     int alpha = INT_MIN + 1, beta = INT_MAX;
 
-    Moves moves;
-    moves.generateMoves(player, opponent);
-
     unsigned long long current_hash = positions.lastHash();
     
-    // Lookup transposition table from previous searches
-    Entry* position_tt = tt.get(current_hash, num_pieces, moves);
-    if (position_tt && position_tt->depth >= depth) {
-        switch (position_tt->node_flag) {
+    // Lookup transposition table from previous searches, before generating the moves since an exact entry ends the search
+    Entry position_tt;
+    bool tt_hit = context.tt.get(current_hash, num_pieces, player, position_tt) && position_tt.best_move != NULL_MOVE &&
+                  isLegal(position_tt.best_move, player, opponent);
+    if (tt_hit && position_tt.depth >= depth) {
+        switch (position_tt.node_flag) {
         case Exact:
-            ponder = getPonder(position_tt->best_move, player, opponent, current_hash);
+            ponder = getPonder(context, position_tt.best_move, player, opponent, current_hash);
 
-            return { position_tt->eval, position_tt->best_move, ponder, position_tt->depth };
+            // Positive if white is winning, as the evaluation returned after searching
+            return { player.is_white ? position_tt.eval : -position_tt.eval, position_tt.best_move, ponder, position_tt.depth };
 
         case UpperBound:
-            beta = position_tt->eval;
+            beta = position_tt.eval;
             break;
 
         case LowerBound:
-            alpha = position_tt->eval;
-            best_move = position_tt->best_move;
+            alpha = position_tt.eval;
+            best_move = position_tt.best_move;
             break;
         }
     }
@@ -130,38 +208,48 @@ SearchResult FindBestMove(int depth, Player& player, Player& opponent, HashPosit
     int start = positions.start;
     positions.branch();
 
-    std::vector<std::array<unsigned short, 2>> killer_moves(depth);
+    context.killer_moves.assign(depth, {});
 
-    moves.orderMoves(player, opponent, position_tt, nullptr);
+    Moves moves;
+    moves.generateMoves(player, opponent);
+    moves.orderMoves(player, opponent, tt_hit ? &position_tt : nullptr, nullptr, context.history_table);
     unsigned short move;
+    int move_number = 0;
 
-    nnue.setPosition(player, opponent);
+    context.nnue.setPosition(player, opponent);
 
     while (move = moves.getNextOrderedMove()) {
-        if (timed_out) break;
+        if (context.stop) break;
+
+        // Show progress on long iterations
+        move_number++;
+        if (context.print_info && elapsedMs(context) > 3000)
+            std::cout << "info depth " << depth << " currmove " << moveToStr(move) << " currmovenumber " << move_number << std::endl;
 
         unsigned short move_flag = getMoveFlag(move);
 
-        MoveInfo mv_inf = makeMove(move, player, opponent, current_hash);
+        MoveInfo mv_inf = makeMove(move, player, opponent, current_hash, &context.nnue);
+        if (depth > 1) context.tt.prefetch(mv_inf.hash);
+
         int new_half_moves = positions.updatePositions(mv_inf.capture_flag, move_flag, mv_inf.hash, half_moves);
         int new_num_pieces = num_pieces - ((mv_inf.capture_flag != no_capture || move_flag == en_passant) ? 1 : 0);
         
-        int eval = -Search(depth - 1, -beta, -alpha, opponent, player, positions, new_half_moves, new_num_pieces, killer_moves);
+        int eval = -Search(context, depth - 1, -beta, -alpha, opponent, player, positions, new_half_moves, new_num_pieces, 1);
         
         if (eval > alpha) {
             alpha = eval;
             best_move = move;
         }
 
-        unmakeMove(move, player, opponent, mv_inf);
+        unmakeMove(move, player, opponent, mv_inf, &context.nnue);
         positions.clear();
         positions.start = start;
     }
 
     positions.unbranch(branch_id, start);
-    nodeFlag nf = timed_out ? LowerBound : Exact;
+    nodeFlag nf = context.stop ? LowerBound : Exact;
     if (alpha > INT_MIN + 1)
-        tt.store(current_hash, best_move, depth, nf, alpha, num_pieces, position_tt);
+        context.tt.store(current_hash, best_move, depth, nf, alpha, num_pieces);
 
     // Restore attacks and squares to uncheck bitboards
     opponent.bitboards.attacks = attacks;
@@ -170,105 +258,140 @@ SearchResult FindBestMove(int depth, Player& player, Player& opponent, HashPosit
     // Make returned evaluation positive if white is winning and negative if black is winning
     if (!player.is_white) alpha = -alpha;
 
-    if (timed_out) depth--;
+    if (context.stop) depth--;
 
-    ponder = getPonder(best_move, player, opponent, current_hash);
+    ponder = getPonder(context, best_move, player, opponent, current_hash);
 
     return { alpha, best_move, ponder, (unsigned short) depth };
 }
 
 
-int Search(int depth, int alpha, int beta, Player& player, Player& opponent, HashPositions& positions, int half_moves, 
-           int num_pieces, std::vector<std::array<unsigned short, 2>>& killer_moves, bool reduced, bool used_null_move) {
+int Search(SearchContext& context, int depth, int alpha, int beta, Player& player, Player& opponent, HashPositions& positions, 
+           int half_moves, int num_pieces, int ply, bool reduced, bool used_null_move) {
 
     // Cancel search if timed out
-    if (timed_out) return INT_MAX;
+    if (context.stop) return INT_MAX;
+
+    context.addNode();
+    SearchStats::count(context.stats.search_nodes);
+    if (ply > context.seldepth) context.seldepth = ply;
 
-    // Check draws
-    GameOutcome game_outcome = getGameOutcome(player, opponent, positions, half_moves);
+    // Check draws, below the children of the root material can only become insufficient after a capture (which sets half_moves to 0)
+    GameOutcome game_outcome = getGameOutcome(player, opponent, positions, half_moves, half_moves == 0 || ply == 1);
     if (game_outcome != ongoing) return 0;
 
-    // Search only captures when desired depth is reached
-    if (depth == 0) {
-        return quiescenceSearch(alpha, beta, player, opponent, num_pieces);
+    // If the player can repeat a position the evaluation is at least a draw, which may alredy be enough for a cutoff
+    if (alpha < 0 && hasUpcomingRepetition(player, positions, half_moves, ply)) {
+        SearchStats::count(context.stats.upcoming_repetitions);
+        alpha = 0;
+        if (alpha >= beta) return alpha;
     }
 
-    Moves moves;
-    moves.generateMoves(player, opponent);
-
-    // Check Checkamte or Stalemate
-    if (moves.num_moves == 0) {
-        if (opponent.bitboards.attacks & player.bitboards.king) { // Checkmate
-            return checkmated_eval;
-        }
-        else { // Stalemate
-            return 0;
-        }
+    // Search only captures when desired depth is reached
+    unsigned long long current_hash = positions.lastHash();
+    if (depth == 0) {
+        return quiescenceSearch(context, alpha, beta, player, opponent, current_hash, num_pieces, ply);
     }
 
-    // Lookup transposition table from previous searches
-    unsigned long long current_hash = positions.lastHash();
+    // Lookup transposition table from previous searches, the move of the entry is checked for legality by the move picker
     unsigned short best_move = 0;
-    Entry* position_tt = tt.get(current_hash, num_pieces, moves);
-    if (position_tt && position_tt->depth >= depth) {
-        switch (position_tt->node_flag) {
+    Entry position_tt;
+    bool tt_hit = context.tt.get(current_hash, num_pieces, player, position_tt);
+    SearchStats::count(context.stats.tt_probes);
+    if (tt_hit) SearchStats::count(context.stats.tt_hits);
+
+    if (tt_hit && position_tt.depth >= depth) {
+        switch (position_tt.node_flag) {
         case Exact:
-            return position_tt->eval;
+            SearchStats::count(context.stats.tt_cutoffs);
+            return position_tt.eval;
 
         case UpperBound:
-            if (alpha >= position_tt->eval) return position_tt->eval;
-            if (beta > position_tt->eval) beta = position_tt->eval;
+            if (alpha >= position_tt.eval) {
+                SearchStats::count(context.stats.tt_cutoffs);
+                return position_tt.eval;
+            }
+            if (beta > position_tt.eval) beta = position_tt.eval;
             break;
 
         case LowerBound:
-            if (position_tt->eval >= beta) return position_tt->eval;
-            if (alpha < position_tt->eval) {
-                alpha = position_tt->eval;
-                best_move = position_tt->best_move;
+            if (position_tt.eval >= beta) {
+                SearchStats::count(context.stats.tt_cutoffs);
+                return position_tt.eval;
+            }
+            if (alpha < position_tt.eval) {
+                alpha = position_tt.eval;
+                best_move = position_tt.best_move;
             }
             break;
         }
     }
 
+    int branch_id = positions.branch_id;
+    int start = positions.start;
+    positions.branch();
+
     // Null-Move Pruning
     if (!used_null_move && nullMove(player, opponent) && depth >= 3) {
 
-        MoveInfo mv_inf = makeMove(NULL_MOVE, player, opponent, current_hash);
-        int eval = -Search(depth - 3, -beta, -beta + 1, opponent, player, positions, half_moves, num_pieces, killer_moves, reduced, true); // R = 2
-        unmakeMove(NULL_MOVE, player, opponent, mv_inf);
+        unsigned long long attacks = opponent.bitboards.attacks, squares_to_uncheck = player.bitboards.squares_to_uncheck;
+        SearchStats::count(context.stats.null_move_tries);
 
-        if (eval >= beta) return eval;
-    }
+        MoveInfo mv_inf = makeMove(NULL_MOVE, player, opponent, current_hash, &context.nnue);
+        context.tt.prefetch(mv_inf.hash);
+        positions.addNullMove(mv_inf.hash);
 
-    int branch_id = positions.branch_id;
-    int start = positions.start;
-    positions.branch();
+        int eval = -Search(context, depth - 3, -beta, -beta + 1, opponent, player, positions, half_moves, num_pieces, ply + 1, reduced, true); // R = 2
+        unmakeMove(NULL_MOVE, player, opponent, mv_inf, &context.nnue);
+        positions.clear();
+        positions.start = start;
 
-    moves.orderMoves(player, opponent, position_tt, &killer_moves[depth]);
+        if (eval >= beta) {
+            SearchStats::count(context.stats.null_move_cutoffs);
+            positions.unbranch(branch_id, start);
+            return eval;
+        }
+
+        // Restore attacks and squares to uncheck bitboards, moves are generated after the null move
+        opponent.bitboards.attacks = attacks;
+        player.bitboards.squares_to_uncheck = squares_to_uncheck;
+    }
+
+    // Moves are generated lazily, so a fail high on the TT move or a good capture skips generating the quiet moves
+    std::vector<std::array<unsigned short, 2>>& killer_moves = context.killer_moves;
+    MovePicker move_picker(player, opponent, tt_hit ? position_tt.best_move : NULL_MOVE, killer_moves[depth], context.history_table);
     unsigned short move;
     int best_eval = INT_MIN + 1;
     int mv_pos = 0;
+    int num_moves_searched = 0;
     bool pv_search = true;
     bool player_in_check = (player.bitboards.king & opponent.bitboards.attacks);
 
-    while (move = moves.getNextOrderedMove()) {
-        if (timed_out) break;
+    while (move = move_picker.nextMove()) {
+        if (context.stop) break;
+
+        num_moves_searched++;
 
         unsigned short move_flag = getMoveFlag(move);
 
-        MoveInfo mv_inf = makeMove(move, player, opponent, current_hash);
+        MoveInfo mv_inf = makeMove(move, player, opponent, current_hash, &context.nnue);
+
+        // The child is probed right after checking for draws, the hash is known long before that
+        context.tt.prefetch(mv_inf.hash);
+
         int new_half_moves = positions.updatePositions(mv_inf.capture_flag, move_flag, mv_inf.hash, half_moves);
-        int new_num_pieces = num_pieces - ((mv_inf.capture_flag == no_capture || move_flag == en_passant) ? 0 : 1);
+        int new_num_pieces = num_pieces - ((mv_inf.capture_flag == no_capture && move_flag != en_passant) ? 0 : 1);
 
         // PV Search
         int eval;
         if (pv_search)
-            eval = -Search(depth - 1, -beta, -alpha, opponent, player, positions, new_half_moves, new_num_pieces, killer_moves, reduced);
+            eval = -Search(context, depth - 1, -beta, -alpha, opponent, player, positions, new_half_moves, new_num_pieces, ply + 1, reduced);
         else {
             int d = depth - 1;
             bool reduce_search = false;
             if (!reduced && reduceMove(mv_pos, move, d, mv_inf, player, opponent, player_in_check, killer_moves[depth])) {
                 reduce_search = true;
+                SearchStats::count(context.stats.lmr_reductions);
                 /*
                     First 2 moves: do not reduce
                     3rd and 4th move: reduce by 1
@@ -279,20 +402,22 @@ int Search(int depth, int alpha, int beta, Player& player, Player& opponent, Has
                 else if (mv_pos <= 6) d -= 2;
                 else d /= 3;
             }
-            eval = -Search(d, -alpha - 1, -alpha, opponent, player, positions, new_half_moves, new_num_pieces, killer_moves, reduce_search);
+            eval = -Search(context, d, -alpha - 1, -alpha, opponent, player, positions, new_half_moves, new_num_pieces, ply + 1, reduce_search);
             
             if (eval > alpha && eval < beta) { // re-search
+                if (reduce_search) SearchStats::count(context.stats.lmr_researches);
+
                 AttacksInfo player_attacks = generateAttacksInfo(player.is_white, player.bitboards, player.bitboards.all_pieces,
                                                                  player.locations.king, opponent.locations.king);
 
                 player.bitboards.attacks = player_attacks.attacks_bitboard;
                 opponent.bitboards.squares_to_uncheck = player_attacks.opponent_squares_to_uncheck;
 
-                eval = -Search(depth - 1, -beta, -alpha, opponent, player, positions, new_half_moves, new_num_pieces, killer_moves, reduced);
+                eval = -Search(context, depth - 1, -beta, -alpha, opponent, player, positions, new_half_moves, new_num_pieces, ply + 1, reduced);
             }
         }
 
-        unmakeMove(move, player, opponent, mv_inf);
+        unmakeMove(move, player, opponent, mv_inf, &context.nnue);
         positions.clear();
         positions.start = start;
 
@@ -301,12 +426,15 @@ int Search(int depth, int alpha, int beta, Player& player, Player& opponent, Has
             best_eval = eval;
             best_move = move;
 
+            SearchStats::count(context.stats.beta_cutoffs);
+            if (num_moves_searched == 1) SearchStats::count(context.stats.first_move_cutoffs);
+
             // Killer moves and History heuristic
             if (!isCapture(move, opponent.bitboards.friendly_pieces) && killer_moves[depth][0] != move) {
                 killer_moves[depth][1] = killer_moves[depth][0];
                 killer_moves[depth][0] = move;
 
-                history_table.record(player.is_white, move_flag, getFinalSquare(move), depth);
+                context.history_table.record(player.is_white, move_flag, getFinalSquare(move), depth);
             }
             
             break;
@@ -326,48 +454,96 @@ int Search(int depth, int alpha, int beta, Player& player, Player& opponent, Has
 
     positions.unbranch(branch_id, start);
 
+    // Check Checkamte or Stalemate, only known after the move picker runs out of moves
+    if (num_moves_searched == 0 && !context.stop) {
+        if (player_in_check) { // Checkmate
+            return checkmated_eval;
+        }
+        else { // Stalemate
+            return 0;
+        }
+    }
+
     // Ignore result of the search if couldnt complete search and failed low, since we cant draw any conclusions from that
-    if (best_eval <= alpha && timed_out) {
+    if (best_eval <= alpha && context.stop) {
         return INT_MAX;
     }
 
     nodeFlag nf;
     if (best_eval <= alpha) nf = UpperBound; // Fail Low
-    else if (timed_out || best_eval >= beta) nf = LowerBound; // Timed out or Fail High
+    else if (context.stop || best_eval >= beta) nf = LowerBound; // Timed out or Fail High
     else nf = Exact;
 
-    if (best_eval > alpha || !timed_out) // Don't store score if failed low and timed out
-        tt.store(current_hash, best_move, depth, nf, best_eval, num_pieces, position_tt);
+    if (best_eval > alpha || !context.stop) // Don't store score if failed low and timed out
+        context.tt.store(current_hash, best_move, depth, nf, best_eval, num_pieces);
     
     return best_eval;
 }
 
 
-int quiescenceSearch(int alpha, int beta, Player& player, Player& opponent, int num_pieces) {
+/*
+    Positions are stored in the transposition table with depth 0, so that capture sequences reached from different
+    moves of the main search are only searched once, and an entry of any depth is good enough for a cutoff. Fail highs
+    of the standing evaluation are not stored, they are at most leaves and would replace the entries that have a move.
+*/
+int quiescenceSearch(SearchContext& context, int alpha, int beta, Player& player, Player& opponent, unsigned long long hash, int num_pieces, int ply) {
     Moves moves;
 
+    context.addNode();
+    SearchStats::count(context.stats.qsearch_nodes);
+    if (ply > context.seldepth) context.seldepth = ply;
+
     // Generates captures updates player attacks bitboard (needed in Evaluate), does not
     // include king attacks to squares that are defedend or attacks of pinned pieces that 
     // would leave the king in check if played.
     moves.generateCaptures(player, opponent);
 
+    // Probed after generating the captures, which gives the prefetch done by the parent time to load the bucket
+    Entry position_tt;
+    bool tt_hit = context.tt.get(hash, num_pieces, player, position_tt);
+    SearchStats::count(context.stats.qsearch_tt_probes);
+    if (tt_hit) {
+        SearchStats::count(context.stats.qsearch_tt_hits);
+
+        if (position_tt.node_flag == Exact || (position_tt.node_flag == UpperBound && position_tt.eval <= alpha) ||
+            (position_tt.node_flag == LowerBound && position_tt.eval >= beta)) {
+            SearchStats::count(context.stats.qsearch_tt_cutoffs);
+            return std::clamp<int>(position_tt.eval, alpha, beta);
+        }
+    }
+
     // Low bound on evaluation, since almost always making a move is better than doing nothing
-    int standing_eval = nnue.evaluate();
+    int standing_eval = context.nnue.evaluate(player, opponent);
     if (standing_eval >= beta) return standing_eval;
+
+    int original_alpha = alpha;
     if (standing_eval > alpha ) alpha = standing_eval;
 
-    moves.orderMoves(player, opponent, nullptr, nullptr);
+    moves.orderMoves(player, opponent, tt_hit ? &position_tt : nullptr, nullptr, context.history_table);
     unsigned short move;
+    unsigned short best_move = NULL_MOVE;
 
     while (move = moves.getNextOrderedMove()) {
-        MoveInfo mv_inf = makeMove(move, player, opponent, 0);
-        int eval = -quiescenceSearch(-beta, -alpha, opponent, player, num_pieces - 1);
-        unmakeMove(move, player, opponent, mv_inf);
+        MoveInfo mv_inf = makeMove(move, player, opponent, hash, &context.nnue);
+        context.tt.prefetch(mv_inf.hash);
+
+        // Only captures are generated (without en passants), the en passant check keeps the count the same as in Search
+        int new_num_pieces = num_pieces - ((mv_inf.capture_flag == no_capture && getMoveFlag(move) != en_passant) ? 0 : 1);
 
-        if (eval >= beta) return eval;
-        if (eval > alpha) alpha = eval;
+        int eval = -quiescenceSearch(context, -beta, -alpha, opponent, player, mv_inf.hash, new_num_pieces, ply + 1);
+        unmakeMove(move, player, opponent, mv_inf, &context.nnue);
+
+        if (eval >= beta) {
+            context.tt.store(hash, move, 0, LowerBound, eval, num_pieces);
+            return eval;
+        }
+        if (eval > alpha) {
+            alpha = eval;
+            best_move = move;
+        }
     }
 
+    context.tt.store(hash, best_move, 0, (alpha > original_alpha) ? Exact : UpperBound, alpha, num_pieces);
     return alpha;
 }
 
@@ -408,7 +584,7 @@ bool reduceMove(int mv_pos, unsigned short mv, int depth, const MoveInfo& mv_inf
     return true;
 }
 
-void repetition(Player& player, Player& opponent, const HashPositions& positions) {
+void repetition(SearchContext& context, Player& player, Player& opponent, const HashPositions& positions) {
 
     // Check draw by repetition
     if (positions.numPositions() >= 5) { // Can only repeat a position twice after at leat 5 moves without captures or pawn moves
@@ -422,10 +598,11 @@ void repetition(Player& player, Player& opponent, const HashPositions& positions
                 unsigned long long squares_to_uncheck = player.bitboards.squares_to_uncheck;
 
                 unsigned long long hash = positions.lastHash();
-                Entry* entry = tt.get(hash, std::popcount(player.bitboards.all_pieces), player);
+                Entry entry;
 
                 // Check if Principal Variation leads to draw by repetition
-                deal_repetition(player, opponent, positions, hash, positions[i], entry);
+                if (context.tt.get(hash, std::popcount(player.bitboards.all_pieces), player, entry))
+                    deal_repetition(context, player, opponent, positions, hash, positions[i], entry);
 
                 // Restore attacks and squares to uncheck bitboards
                 opponent.bitboards.attacks = attacks;
@@ -437,11 +614,11 @@ void repetition(Player& player, Player& opponent, const HashPositions& positions
     }
 }
 
-bool deal_repetition(Player& player, Player& opponent, const HashPositions& positions, unsigned long long hash, unsigned long long repeated_position, Entry* entry) {
-    if (!entry) return false;
+bool deal_repetition(SearchContext& context, Player& player, Player& opponent, const HashPositions& positions, unsigned long long hash, unsigned long long repeated_position, const Entry& entry) {
+    if (entry.best_move == NULL_MOVE) return false;
 
-    int eval = entry->eval;
-    MoveInfo mv_inf = makeMove(entry->best_move, player, opponent, hash, false);
+    unsigned long long position_hash = hash;
+    MoveInfo mv_inf = makeMove(entry.best_move, player, opponent, hash);
     hash = mv_inf.hash;
 
     // Repetition of moves
@@ -449,45 +626,117 @@ bool deal_repetition(Player& player, Player& opponent, const HashPositions& posi
         
         // If player is winning then it is an hallucination (since next move is a draw), so the evaluation is an upper bound.
         // Otherwise, player can get a guaranteed draw, so evaluation is 0.
-        if (eval > 0) entry->node_flag = LowerBound;
-        else entry->node_flag = Exact;
-        entry->eval = 0;
+        Entry draw_entry = entry;
+        draw_entry.node_flag = (entry.eval > 0) ? LowerBound : Exact;
+        draw_entry.eval = 0;
+        context.tt.replace(position_hash, entry.num_pieces, draw_entry);
         
-        unmakeMove(entry->best_move, player, opponent, mv_inf, false);
+        unmakeMove(entry.best_move, player, opponent, mv_inf);
         return true;
     }
     else if (!positions.contains(hash)) { // Return false if new position is not repeated
-        unmakeMove(entry->best_move, player, opponent, mv_inf, false);
+        unmakeMove(entry.best_move, player, opponent, mv_inf);
         return false;
     }
 
-    Entry* new_entry = tt.get(hash, std::popcount(player.bitboards.all_pieces), opponent);
-
-    bool result = deal_repetition(opponent, player, positions, hash, repeated_position, new_entry);
-    unmakeMove(entry->best_move, player, opponent, mv_inf, false);
+    Entry new_entry;
+    bool result = context.tt.get(hash, std::popcount(player.bitboards.all_pieces), opponent, new_entry) && 
+                  deal_repetition(context, opponent, player, positions, hash, repeated_position, new_entry);
+    unmakeMove(entry.best_move, player, opponent, mv_inf);
 
     // Delete the rest of the PV line from the tt
-    if (result)
-        entry->num_pieces = 100;
+    if (result) {
+        Entry deleted_entry = entry;
+        deleted_entry.num_pieces = 100;
+        context.tt.replace(position_hash, entry.num_pieces, deleted_entry);
+    }
 
     return result;
 }
 
-unsigned short getPonder(unsigned short best_move, Player& player, Player& opponent, unsigned long long hash) {
+unsigned short getPonder(SearchContext& context, unsigned short best_move, Player& player, Player& opponent, unsigned long long hash) {
     unsigned short ponder;
 
     unsigned long long attacks = opponent.bitboards.attacks;
     unsigned long long squares_to_uncheck = player.bitboards.squares_to_uncheck;
 
-    MoveInfo mv_inf = makeMove(best_move, player, opponent, hash, false);
+    MoveInfo mv_inf = makeMove(best_move, player, opponent, hash);
     
-    Entry* entry = tt.get(mv_inf.hash, std::popcount(player.bitboards.all_pieces), opponent);
-    ponder = (entry) ? entry->best_move : 0;
+    // The entry may have been stored by the quiescence search, so its move is checked as in extendPV
+    Entry entry;
+    bool is_ponder_legal = context.tt.get(mv_inf.hash, std::popcount(player.bitboards.all_pieces), opponent, entry) &&
+                           entry.best_move != NULL_MOVE && isLegal(entry.best_move, opponent, player);
+    ponder = is_ponder_legal ? entry.best_move : 0;
 
-    unmakeMove(best_move, player, opponent, mv_inf, false);
+    unmakeMove(best_move, player, opponent, mv_inf);
 
     opponent.bitboards.attacks = attacks;
     player.bitboards.squares_to_uncheck = squares_to_uncheck;
 
     return ponder;
 }
+
+// Moves of the principal variation, the moves after the best move are taken from the transposition table
+std::vector<unsigned short> getPV(SearchContext& context, unsigned short best_move, int max_length, Player& player, Player& opponent, unsigned long long hash) {
+    std::vector<unsigned short> pv = { best_move };
+    std::vector<unsigned long long> hashes = { hash };
+
+    unsigned long long attacks = opponent.bitboards.attacks;
+    unsigned long long squares_to_uncheck = player.bitboards.squares_to_uncheck;
+
+    MoveInfo mv_inf = makeMove(best_move, player, opponent, hash);
+    extendPV(context, pv, max_length, opponent, player, mv_inf.hash, hashes);
+    unmakeMove(best_move, player, opponent, mv_inf);
+
+    opponent.bitboards.attacks = attacks;
+    player.bitboards.squares_to_uncheck = squares_to_uncheck;
+
+    return pv;
+}
+
+// Stops at a repeated position or when the entry is missing or its move is not legal (entry of another position)
+void extendPV(SearchContext& context, std::vector<unsigned short>& pv, int max_length, Player& player, Player& opponent, unsigned long long hash, std::vector<unsigned long long>& hashes) {
+    if ((int) pv.size() >= max_length || std::find(hashes.begin(), hashes.end(), hash) != hashes.end()) return;
+
+    Entry entry;
+    if (!context.tt.get(hash, std::popcount(player.bitboards.all_pieces), player, entry) || entry.best_move == NULL_MOVE ||
+        !isLegal(entry.best_move, player, opponent))
+        return;
+
+    pv.push_back(entry.best_move);
+    hashes.push_back(hash);
+
+    MoveInfo mv_inf = makeMove(entry.best_move, player, opponent, hash);
+    extendPV(context, pv, max_length, opponent, player, mv_inf.hash, hashes);
+    unmakeMove(entry.best_move, player, opponent, mv_inf);
+}
+
+/*
+    Evaluations don't keep the distance to mate, a mate is reported as being as far as the depth of the iteration
+    that found it, which is the first iteration deep enough to see it (and the search stops there).
+*/
+void printInfo(SearchContext& context, const SearchResult& result, Player& player, Player& opponent, const HashPositions& positions) {
+    long long time = elapsedMs(context);
+    unsigned long long nodes = context.totalNodes();
+
+    // Evaluation of the result is positive if white is winning, UCI expects it from the point of view of the player
+    int eval = player.is_white ? result.evaluation : -result.evaluation;
+
+    std::cout << "info depth " << result.depth << " seldepth " << std::max<int>(context.seldepth, result.depth);
+
+    if (eval == checkmate_eval)         std::cout << " score mate " << (result.depth + 1) / 2;
+    else if (eval == checkmated_eval)   std::cout << " score mate -" << result.depth / 2;
+    else                                std::cout << " score cp " << eval;
+
+    std::cout << " nodes " << nodes << " nps " << nodes * 1000 / std::max<long long>(time, 1) << " time " << time
+              << " hashfull " << context.tt.hashfull() << " pv";
+
+    for (unsigned short move : getPV(context, result.best_move, result.depth, player, opponent, positions.lastHash()))
+        std::cout << ' ' << moveToStr(move);
+
+    std::cout << std::endl;
+}
+
+long long elapsedMs(const SearchContext& context) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - context.start_time).count();
+}
@@ -3,6 +3,7 @@
 #include "MagicBitboards.h"
 #include "Moves.h"
 #include "Player.h"
+#include "SearchContext.h"
 #include "TranspositionTable.h"
 #include "Zobrist.h"
 #include <chrono>
@@ -12,22 +13,22 @@ struct SearchResult {
 	unsigned short best_move, ponder, depth;
 };
 
-void stopSearch(int id);
+constexpr int max_threads = 256;
 
 // Returns the move with the highest evaluation
-void FindBestMoveItrDeepening(std::chrono::milliseconds time, Player& player, Player& opponent, HashPositions& positions, int half_moves, SearchResult& result);
-inline SearchResult FindBestMoveItrDeepening(std::chrono::milliseconds time, Player& player, Player& opponent, HashPositions& positions, int half_moves) {
+void FindBestMoveItrDeepening(SearchContext& context, std::chrono::milliseconds time, Player& player, Player& opponent, HashPositions& positions, int half_moves, SearchResult& result);
+inline SearchResult FindBestMoveItrDeepening(SearchContext& context, std::chrono::milliseconds time, Player& player, Player& opponent, HashPositions& positions, int half_moves) {
 	SearchResult result;
-	FindBestMoveItrDeepening(time, player, opponent, positions, half_moves, result);
+	FindBestMoveItrDeepening(context, time, player, opponent, positions, half_moves, result);
 	return result;
 }
 
 // Returns the move with the highest evaluation
-void FindBestMoveItrDeepening(int depth, Player& player, Player& opponent, HashPositions& positions, int half_moves, SearchResult& result);
-inline SearchResult FindBestMoveItrDeepening(int depth, Player& player, Player& opponent, HashPositions& positions, int half_moves) {
+void FindBestMoveItrDeepening(SearchContext& context, int depth, Player& player, Player& opponent, HashPositions& positions, int half_moves, SearchResult& result);
+inline SearchResult FindBestMoveItrDeepening(SearchContext& context, int depth, Player& player, Player& opponent, HashPositions& positions, int half_moves) {
 	SearchResult result;
-	FindBestMoveItrDeepening(depth, player, opponent, positions, half_moves, result);
+	FindBestMoveItrDeepening(context, depth, player, opponent, positions, half_moves, result);
 	return result;
 }
 
-SearchResult FindBestMove(int depth, Player& player, Player& opponent, HashPositions& positions, int half_moves);
+SearchResult FindBestMove(SearchContext& context, int depth, Player& player, Player& opponent, HashPositions& positions, int half_moves);
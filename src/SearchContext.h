@@ -0,0 +1,61 @@
+#pragma once
+#include "HistoryTable.h"
+#include "SearchStats.h"
+#include "TranspositionTable.h"
+#include "EvaluateNNUE.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+/*
+	State of a single search thread, every function of the search receives the context of the thread running it
+	instead of using global state, so that independent searches can run at the same time in the same process.
+	Threads of the same search (Lazy SMP helpers) share the transposition table and the stop flag of the main thread.
+*/
+struct SearchContext {
+private:
+	std::atomic_bool stop_flag = false;
+
+public:
+	TranspositionTable&							tt;
+	std::atomic_bool&							stop;
+	NNUE										nnue			= NNUE();
+	HistoryTable								history_table	= HistoryTable();
+	std::vector<std::array<unsigned short, 2>>	killer_moves;
+	std::atomic<unsigned long long>				nodes			= 0; // Only written by the thread of the context
+	int											seldepth		= 0; // Highest ply reached in the current iteration
+	int											num_threads		= 1;
+	SearchStats									stats;
+	bool										print_info		= false; // UCI info lines, only by the main thread
+
+	std::chrono::steady_clock::time_point		start_time;
+	std::vector<std::unique_ptr<SearchContext>>	helpers; // Contexts of the helper threads of the last search
+
+	// Context of the main thread of a search
+	SearchContext(TranspositionTable& tt) : tt(tt), stop(stop_flag) {}
+
+	// Context of a helper thread, sharing the transposition table and stop flag of the main thread
+	SearchContext(TranspositionTable& tt, std::atomic_bool& stop) : tt(tt), stop(stop) {}
+
+	SearchContext(const SearchContext&) = delete;
+	SearchContext& operator=(const SearchContext&) = delete;
+
+	// Relaxed load and store instead of an atomic increment, which would be much slower, since there is a single writer
+	inline void addNode() { nodes.store(nodes.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+
+	// Nodes searched by this thread and all of its helpers, can be read while they are searching
+	inline unsigned long long totalNodes() const {
+		unsigned long long total = nodes.load(std::memory_order_relaxed);
+		for (const std::unique_ptr<SearchContext>& helper : helpers) total += helper->nodes.load(std::memory_order_relaxed);
+		return total;
+	}
+
+	// Stats of this thread followed by the ones of its helpers
+	inline std::vector<SearchStats> threadStats() const {
+		std::vector<SearchStats> thread_stats = { stats };
+		for (const std::unique_ptr<SearchContext>& helper : helpers) thread_stats.push_back(helper->stats);
+		return thread_stats;
+	}
+};
@@ -0,0 +1,70 @@
+#include "SearchStats.h"
+#include <sstream>
+#include <string>
+#include <vector>
+
+SearchStats& SearchStats::operator+=(const SearchStats& other) {
+	search_nodes		+= other.search_nodes;
+	qsearch_nodes		+= other.qsearch_nodes;
+	tt_probes			+= other.tt_probes;
+	tt_hits				+= other.tt_hits;
+	tt_cutoffs			+= other.tt_cutoffs;
+	qsearch_tt_probes	+= other.qsearch_tt_probes;
+	qsearch_tt_hits		+= other.qsearch_tt_hits;
+	qsearch_tt_cutoffs	+= other.qsearch_tt_cutoffs;
+	beta_cutoffs		+= other.beta_cutoffs;
+	first_move_cutoffs	+= other.first_move_cutoffs;
+	null_move_tries		+= other.null_move_tries;
+	null_move_cutoffs	+= other.null_move_cutoffs;
+	lmr_reductions		+= other.lmr_reductions;
+	lmr_researches		+= other.lmr_researches;
+	upcoming_repetitions += other.upcoming_repetitions;
+	return *this;
+}
+
+static void writeCounts(std::ostringstream& json, const SearchStats& stats) {
+	json << "\"search_nodes\": " << stats.search_nodes
+		 << ", \"qsearch_nodes\": " << stats.qsearch_nodes
+		 << ", \"tt_probes\": " << stats.tt_probes
+		 << ", \"tt_hits\": " << stats.tt_hits
+		 << ", \"tt_cutoffs\": " << stats.tt_cutoffs
+		 << ", \"qsearch_tt_probes\": " << stats.qsearch_tt_probes
+		 << ", \"qsearch_tt_hits\": " << stats.qsearch_tt_hits
+		 << ", \"qsearch_tt_cutoffs\": " << stats.qsearch_tt_cutoffs
+		 << ", \"beta_cutoffs\": " << stats.beta_cutoffs
+		 << ", \"first_move_cutoffs\": " << stats.first_move_cutoffs
+		 << ", \"null_move_tries\": " << stats.null_move_tries
+		 << ", \"null_move_cutoffs\": " << stats.null_move_cutoffs
+		 << ", \"lmr_reductions\": " << stats.lmr_reductions
+		 << ", \"lmr_researches\": " << stats.lmr_researches
+		 << ", \"upcoming_repetitions\": " << stats.upcoming_repetitions;
+}
+
+static double rate(unsigned long long count, unsigned long long total) {
+	return total ? (double) count / total : 0;
+}
+
+std::string searchStatsToJson(const std::vector<SearchStats>& thread_stats) {
+	std::ostringstream json;
+	SearchStats total;
+
+	json << "{\"threads\": [";
+	for (int i = 0; i < (int) thread_stats.size(); i++) {
+		json << (i ? ", {" : "{");
+		writeCounts(json, thread_stats[i]);
+		json << "}";
+		total += thread_stats[i];
+	}
+
+	json << "], \"total\": {";
+	writeCounts(json, total);
+	json << ", \"tt_hit_rate\": " << rate(total.tt_hits, total.tt_probes)
+		 << ", \"qsearch_tt_hit_rate\": " << rate(total.qsearch_tt_hits, total.qsearch_tt_probes)
+		 << ", \"first_move_cutoff_rate\": " << rate(total.first_move_cutoffs, total.beta_cutoffs)
+		 << ", \"null_move_success_rate\": " << rate(total.null_move_cutoffs, total.null_move_tries)
+		 << ", \"lmr_research_rate\": " << rate(total.lmr_researches, total.lmr_reductions)
+		 << ", \"qsearch_node_share\": " << rate(total.qsearch_nodes, total.search_nodes + total.qsearch_nodes)
+		 << "}}";
+
+	return json.str();
+}
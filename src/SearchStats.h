@@ -0,0 +1,40 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#ifdef SEARCH_STATS
+constexpr bool search_stats_enabled = true;
+#else
+constexpr bool search_stats_enabled = false;
+#endif
+
+/*
+	Counts of events of the search of a single thread, only counted when built with SEARCH_STATS (CMake option),
+	otherwise every call to count compiles to nothing and the counters are always 0.
+*/
+struct SearchStats {
+	unsigned long long search_nodes			= 0;
+	unsigned long long qsearch_nodes		= 0;
+	unsigned long long tt_probes			= 0;
+	unsigned long long tt_hits				= 0;
+	unsigned long long tt_cutoffs			= 0;
+	unsigned long long qsearch_tt_probes	= 0;
+	unsigned long long qsearch_tt_hits		= 0;
+	unsigned long long qsearch_tt_cutoffs	= 0;
+	unsigned long long beta_cutoffs			= 0;
+	unsigned long long first_move_cutoffs	= 0;
+	unsigned long long null_move_tries		= 0;
+	unsigned long long null_move_cutoffs	= 0;
+	unsigned long long lmr_reductions		= 0;
+	unsigned long long lmr_researches		= 0;
+	unsigned long long upcoming_repetitions	= 0;
+
+	static inline void count(unsigned long long& counter) {
+		if constexpr (search_stats_enabled) counter++;
+	}
+
+	SearchStats& operator+=(const SearchStats& other);
+};
+
+// Counts of each thread and their totals, with the rates derived from them, as a single line of JSON
+std::string searchStatsToJson(const std::vector<SearchStats>& thread_stats);
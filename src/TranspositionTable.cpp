@@ -1,9 +1,95 @@
 #include "TranspositionTable.h"
 #include "MakeMoves.h"
+#include "MappedFile.h"
 #include "Moves.h"
+#include "Zobrist.h"
+#include <algorithm>
 #include <bit>
 #include <cassert>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+/*
+	Memory of the table, on large pages if possible so that probes (which are random accesses over the whole table)
+	don't also miss the TLB. On Windows large pages need the "Lock pages in memory" privilege, without it normal pages
+	are used. On Linux the table is aligned to 2 MB pages and marked for transparent huge pages.
+*/
+static void* allocateLargePages(size_t size) {
+#ifdef _WIN32
+	void* memory = nullptr;
+	size_t large_page_size = GetLargePageMinimum();
+	if (large_page_size) {
+		size_t large_size = (size + large_page_size - 1) / large_page_size * large_page_size;
+		memory = VirtualAlloc(nullptr, large_size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+	}
+	if (!memory) memory = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+	return memory;
+#else
+	constexpr size_t huge_page_size = 2 * 1024 * 1024;
+	size = (size + huge_page_size - 1) / huge_page_size * huge_page_size;
+
+	void* memory = std::aligned_alloc(huge_page_size, size);
+#ifdef MADV_HUGEPAGE
+	if (memory) madvise(memory, size, MADV_HUGEPAGE);
+#endif
+	return memory;
+#endif
+}
+
+static void freeLargePages(void* memory) {
+#ifdef _WIN32
+	if (memory) VirtualFree(memory, 0, MEM_RELEASE);
+#else
+	std::free(memory);
+#endif
+}
+
+// Increased whenever the layout of the file or of the buckets changes
+constexpr uint32_t snapshot_version = 1;
+constexpr std::array<char, 8> snapshot_magic = { 'C', 'E', 'T', 'T', 'S', 'N', 'A', 'P' };
+
+struct SnapshotHeader {
+	std::array<char, 8> magic = snapshot_magic;
+	uint32_t version = snapshot_version;
+	uint32_t bucket_bytes = sizeof(Bucket);
+	uint64_t zobrist_seed = 0;
+	uint64_t size_mb = 0;
+	uint8_t current_generation = 0;
+	uint8_t last_generation_searched = 0;
+	uint8_t padding[30] = {}; // Keeps the buckets that follow aligned to a cache line in the mapped file
+};
+static_assert(sizeof(SnapshotHeader) == 64);
+
+// Xor of the data of the entry that is verified on every read, generation_last_used is left out since
+// it is only a hint for replacement and is updated on reads without rewriting the whole entry.
+static inline uint32_t entryKey(const Entry& entry) {
+	uint32_t low  = entry.best_move | (entry.depth << 16) | (entry.node_flag << 24);
+	uint32_t high = uint16_t(entry.eval) | (entry.num_pieces << 16);
+	return low ^ high;
+}
+
+static inline uint32_t decodeHash(const Entry& entry) {
+	return entry.hash ^ entryKey(entry);
+}
+
+static inline Entry encodeEntry(uint32_t upper_bits_hash, Entry entry) {
+	entry.hash = upper_bits_hash ^ entryKey(entry);
+	return entry;
+}
 
 void Bucket::updateSmallestDepth() {
 	uint8_t smallest_depth = 0xff;
@@ -16,30 +102,142 @@ void Bucket::updateSmallestDepth() {
 }
 
 TranspositionTable::TranspositionTable(size_t size_mb) {
-	assert((size_mb & (size_mb - 1)) == 0, "size_mb must be a power of two.");
-	size_t max_entries = size_mb * 1024 * 1024 / sizeof(Bucket);
-	table.resize(max_entries);
-	index_mask = max_entries - 1; // max_entries is a power of two (...0010000...) so it becomes ...0001111...
+	resize(size_mb);
 }
 
-void TranspositionTable::store(uint64_t hash, unsigned short best_move, uint8_t depth, nodeFlag node_flag, int16_t eval, uint8_t num_pieces, Entry* pos_entry) {
-	last_generation_searched = current_generation;
+TranspositionTable::~TranspositionTable() {
+	freeLargePages(table);
+}
 
-	// Avoid storing the same position multiple times
-	if (pos_entry && pos_entry->hash == unsigned(hash >> 32)) {
-		if (pos_entry->depth < depth || (pos_entry->depth == depth && pos_entry->node_flag != Exact && pos_entry->node_flag == Exact)) {
-			*pos_entry = Entry{ unsigned(hash >> 32), best_move, depth, node_flag, eval, current_generation, num_pieces };
+bool TranspositionTable::resize(size_t size_mb) {
+	bool allocated = allocate(size_mb);
+
+	// The search always needs a table, so without one a smaller table is better than none
+	for (size_t smaller_mb = size_mb; table == nullptr && smaller_mb > 1;) {
+		smaller_mb = std::bit_floor(smaller_mb - 1);
+		allocate(smaller_mb);
+	}
+	if (table == nullptr) throw std::bad_alloc();
+
+	// Also touches every page, so that they are mapped now instead of during the search
+	clear();
+	return allocated;
+}
+
+bool TranspositionTable::allocate(size_t size_mb) {
+	assert(size_mb > 0, "size_mb must be positive.");
+	if (size_mb > (SIZE_MAX >> 20)) return false;
+
+	Bucket* new_table = static_cast<Bucket*>(allocateLargePages(size_mb * 1024 * 1024));
+	if (new_table == nullptr) return false;
+
+	freeLargePages(table);
+	table = new_table;
+	num_buckets = size_mb * 1024 * 1024 / sizeof(Bucket);
+	this->size_mb = size_mb;
+	assert(num_buckets <= (1ULL << 32), "Multiply-high indexing supports at most 2^32 buckets.");
+	return true;
+}
+
+void TranspositionTable::clear(int num_threads) {
+	std::vector<std::thread> threads;
+	size_t buckets_per_thread = (num_buckets + num_threads - 1) / std::max(num_threads, 1);
+
+	for (int i = 0; i < num_threads; i++) {
+		size_t start = std::min(num_buckets, i * buckets_per_thread);
+		size_t end = std::min(num_buckets, start + buckets_per_thread);
+
+		// An entry with all bits 0 is Invalid
+		threads.emplace_back([this, start, end]() { std::memset(static_cast<void*>(table + start), 0, (end - start) * sizeof(Bucket)); });
+	}
+
+	for (std::thread& thread : threads) thread.join();
+
+	num_pieces_root = current_generation = last_generation_searched = 0;
+}
+
+bool TranspositionTable::save(const std::filesystem::path& path) const {
+	SnapshotHeader header;
+	header.zobrist_seed = zobrist_keys.seed;
+	header.size_mb = size_mb;
+	header.current_generation = current_generation;
+	header.last_generation_searched = last_generation_searched;
+
+	std::ofstream out_file(path, std::ios::binary | std::ios::trunc);
+	if (!out_file.is_open()) return false;
+
+	out_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	out_file.write(reinterpret_cast<const char*>(table), num_buckets * sizeof(Bucket));
+
+	return out_file.good();
+}
+
+/*
+	The file is memory mapped and copied into a new table instead of searching on the mapping directly, since the
+	table needs to be writable and on large pages. Mapping still avoids an extra buffer and lets the OS read the
+	file ahead while it is being copied (and keep it in the page cache for the next restart).
+*/
+bool TranspositionTable::load(const std::filesystem::path& path) {
+	MappedFile file;
+	if (!file.open(path) || file.size() < sizeof(SnapshotHeader)) return false;
+
+	SnapshotHeader header;
+	std::memcpy(&header, file.data(), sizeof(header));
+
+	if (header.magic != snapshot_magic || header.version != snapshot_version || header.bucket_bytes != sizeof(Bucket)) return false;
+	if (header.zobrist_seed != zobrist_keys.seed || header.size_mb == 0 || header.size_mb > max_tt_size_mb) return false;
+
+	size_t snapshot_buckets = header.size_mb * 1024 * 1024 / sizeof(Bucket);
+	if (file.size() != sizeof(SnapshotHeader) + snapshot_buckets * sizeof(Bucket)) return false;
+
+	// Filled before replacing the table, so that the current table is kept if the memory can't be allocated
+	Bucket* new_table = static_cast<Bucket*>(allocateLargePages(header.size_mb * 1024 * 1024));
+	if (new_table == nullptr) return false;
+	std::memcpy(static_cast<void*>(new_table), file.data() + sizeof(SnapshotHeader), snapshot_buckets * sizeof(Bucket));
+
+	// Indices of the buckets are not covered by the hash check of the entries, out of range ones would access past the bucket
+	for (size_t i = 0; i < snapshot_buckets; i++) {
+		if (new_table[i].index_free > bucket_size || new_table[i].index_smallest_depth >= bucket_size) {
+			freeLargePages(new_table);
+			return false;
 		}
-		return;
 	}
 
-	int index = hash & index_mask;
-	Bucket& bucket = table[index];
+	freeLargePages(table);
+	table = new_table;
+	num_buckets = snapshot_buckets;
+	size_mb = header.size_mb;
+	num_pieces_root = 0;
+	current_generation = header.current_generation;
+	last_generation_searched = header.last_generation_searched;
+
+	return true;
+}
+
+void TranspositionTable::store(uint64_t hash, unsigned short best_move, uint8_t depth, nodeFlag node_flag, int16_t eval, uint8_t num_pieces) {
+	if (last_generation_searched != current_generation) last_generation_searched = current_generation;
+
+	uint32_t upper_bits_hash = hash >> 32;
+	Entry new_entry = encodeEntry(upper_bits_hash, Entry{ 0, best_move, depth, node_flag, eval, current_generation, num_pieces });
+
+	Bucket& bucket = table[bucketIndex(hash)];
 
-	// Populate first free space if any
-	if (bucket.index_free < bucket_size) {
-		bucket[bucket.index_free] = Entry{ unsigned(hash >> 32), best_move, depth, node_flag, eval, current_generation, num_pieces };
-		if (++bucket.index_free == bucket_size) 
+	// Avoid storing the same position multiple times
+	for (Entry& entry : bucket) {
+		if (decodeHash(entry) == upper_bits_hash && entry.num_pieces == num_pieces) {
+			if (entry.depth < depth || (entry.depth == depth && entry.node_flag != Exact && node_flag == Exact)) {
+				entry = new_entry;
+			}
+			return;
+		}
+	}
+
+	// Populate first free space if any, index_free is read only once since other threads may be writing to it
+	uint8_t index_free = bucket.index_free;
+	if (index_free < bucket_size) {
+		bucket[index_free] = new_entry;
+		bucket.index_free = index_free + 1;
+		if (index_free + 1 == bucket_size) 
 			bucket.updateSmallestDepth();
 
 		return;
@@ -49,12 +247,12 @@ void TranspositionTable::store(uint64_t hash, unsigned short best_move, uint8_t
 	if (bucket.last_gen_fully_checked != current_generation) {
 		for (Entry& entry : bucket) {
 			if (entry.num_pieces > num_pieces_root) { // If the position stored has more pieces than current root position it will never be reached
-				entry = Entry{ unsigned(hash >> 32), best_move, depth, node_flag, eval, current_generation, num_pieces };
+				entry = new_entry;
 				return;
 			}
 	
 			if (entry.generation_last_used <= current_generation - 2) { // Replace if wasn't used in the last move calculation, likely to be unreachable
-				entry = Entry{ unsigned(hash >> 32), best_move, depth, node_flag, eval, current_generation, num_pieces };
+				entry = new_entry;
 				return;
 			}
 		}
@@ -62,38 +260,54 @@ void TranspositionTable::store(uint64_t hash, unsigned short best_move, uint8_t
 	}
 	
 	// Always replace entry with smallest depth
-	uint8_t prev_smallest_depth = bucket[bucket.index_smallest_depth].depth;
-	bucket[bucket.index_smallest_depth] = Entry{ unsigned(hash >> 32), best_move, depth, node_flag, eval, current_generation, num_pieces };
+	uint8_t index_smallest_depth = bucket.index_smallest_depth;
+	uint8_t prev_smallest_depth = bucket[index_smallest_depth].depth;
+	bucket[index_smallest_depth] = new_entry;
 	if (depth > prev_smallest_depth) 
 		bucket.updateSmallestDepth();
 }
 
-Entry* TranspositionTable::get(uint64_t hash, uint32_t num_pieces, const Moves& moves) {
-	uint32_t index = hash & index_mask;
+void TranspositionTable::replace(uint64_t hash, uint8_t num_pieces, const Entry& new_entry) {
+	size_t index = bucketIndex(hash);
 	uint32_t upper_bits_hash = hash >> 32;
 
 	for (Entry& entry : table[index]) {
-		if (entry.hash == upper_bits_hash && entry.num_pieces == num_pieces && moves.isMoveLegal(entry.best_move)) {
-			entry.generation_last_used = current_generation;
-			return &entry;
+		if (decodeHash(entry) == upper_bits_hash && entry.num_pieces == num_pieces) {
+			entry = encodeEntry(upper_bits_hash, new_entry);
+			return;
 		}
 	}
-	return nullptr;
 }
 
-Entry* TranspositionTable::get(uint64_t hash, uint32_t num_pieces, const Player& player){
-	uint32_t index = hash & index_mask;
+bool TranspositionTable::get(uint64_t hash, uint32_t num_pieces, const Player& player, Entry& entry) {
+	size_t index = bucketIndex(hash);
 	uint32_t upper_bits_hash = hash >> 32;
-	for (Entry& entry : table[index]) {
-		if (entry.hash == upper_bits_hash && entry.num_pieces == num_pieces && isPseudoLegal(entry.best_move, player)) {
-			entry.generation_last_used = current_generation;
-			return &entry;
+
+	for (Entry& stored_entry : table[index]) {
+		Entry e = stored_entry;
+		if (decodeHash(e) == upper_bits_hash && e.node_flag != Invalid && e.num_pieces == num_pieces &&
+			(e.best_move == NULL_MOVE || isPseudoLegal(e.best_move, player))) {
+			stored_entry.generation_last_used = current_generation;
+			entry = e;
+			entry.hash = upper_bits_hash;
+			return true;
 		}
 	}
-	return nullptr;
+	return false;
 }
 
 void TranspositionTable::setRoot(uint64_t all_pieces) {
 	if (last_generation_searched == current_generation) current_generation++;
 	num_pieces_root = std::popcount(all_pieces);
 }
+
+int TranspositionTable::hashfull() const {
+	size_t num_sampled = std::min<size_t>(1000 / bucket_size, num_buckets);
+	int num_used = 0;
+
+	for (size_t i = 0; i < num_sampled; i++)
+		for (const Entry& entry : table[i])
+			if (entry.generation_last_used == current_generation) num_used++;
+
+	return num_used * 1000 / std::max<int>(num_sampled * bucket_size, 1);
+}
@@ -1,14 +1,19 @@
 #pragma once
 #include <array>
 #include <cstdint>
-#include <vector>
+#include <filesystem>
+#include <xmmintrin.h>
 #include "Player.h"
 
-class Moves;
-
 enum nodeFlag : uint8_t { Invalid, Exact, UpperBound, LowerBound };
 constexpr int bucket_size = 5;
+constexpr int max_tt_size_mb = 65536;
 
+/*
+	The table is shared by every search thread without any locks, so the hash stored in an entry is xored with
+	the rest of its data (see TranspositionTable.cpp), an entry torn by concurrent writes will then fail the
+	hash check and be treated as a miss. Entries returned by get are copies with the hash already decoded.
+*/
 struct Entry {
 	uint32_t hash = 0;
 	unsigned short best_move = 0;
@@ -19,7 +24,8 @@ struct Entry {
 	uint8_t num_pieces = 0;
 };
 
-struct Bucket {
+// Aligned so that a bucket is always in a single cache line
+struct alignas(64) Bucket {
 private:
 	std::array<Entry, 5> bucket;
 
@@ -40,21 +46,63 @@ public:
 };
 
 class TranspositionTable {
-	std::vector<Bucket> table;
-	uint64_t index_mask = 0;
+	Bucket* table = nullptr; // Backed by large pages when the OS allows it (see allocateLargePages)
+	size_t num_buckets = 0, size_mb = 0;
 	uint8_t num_pieces_root = 0, current_generation = 0, last_generation_searched = 0;
 
+	/*
+		Multiply-high of the lower 32 bits of the hash maps it to [0, num_buckets) for any number of buckets, so the
+		size of the table doesn't need to be a power of two. The upper 32 bits are the ones stored in the entries.
+	*/
+	inline size_t bucketIndex(uint64_t hash) const { return (uint64_t(uint32_t(hash)) * num_buckets) >> 32; }
+
+	// Replaces the memory of the table without initializing the buckets, the old memory is kept if the new can't be allocated
+	bool allocate(size_t size_mb);
+
 public:
 	TranspositionTable(size_t size_mb);
 	TranspositionTable() = default;
+	~TranspositionTable();
+
+	TranspositionTable(const TranspositionTable&) = delete;
+	TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+	/*
+		Reallocates the table with the new size (any number of MB), all entries are lost. Returns false if the memory
+		couldn't be allocated, then the table keeps its old size, or if it had none yet, gets the largest power of two
+		MB smaller than size_mb that can be allocated.
+	*/
+	bool resize(size_t size_mb);
+	size_t sizeMB() const { return size_mb; }
+
+	// Deletes all entries, each thread clears a part of the table
+	void clear(int num_threads = 1);
+
+	/*
+		Snapshot of the table in a file, so that a restarted engine doesn't have to search again the positions it
+		alredy searched. The file is a SnapshotHeader followed by the buckets as they are in memory, load also resizes
+		the table to the size of the snapshot (replacing the size set with resize). Both return false (leaving the table
+		as it was) if the file can't be written or read, if it was saved by a build with different buckets or Zobrist
+		keys, if the snapshot is larger than max_tt_size_mb or its memory can't be allocated, or if a bucket is corrupted.
+	*/
+	bool save(const std::filesystem::path& path) const;
+	bool load(const std::filesystem::path& path);
 
 	void setRoot(uint64_t all_pieces);
 
-	// pos_entry should be the pointer returned in get, or nullptr if get wasn't used.
-	void store(uint64_t hash, unsigned short best_move, uint8_t depth, nodeFlag node_flag, int16_t eval, uint8_t num_pieces, Entry* pos_entry);
+	// Starts loading the bucket of the position into the cache, so that probing it later doesn't wait for memory
+	inline void prefetch(uint64_t hash) const { _mm_prefetch(reinterpret_cast<const char*>(&table[bucketIndex(hash)]), _MM_HINT_T0); }
 
-	Entry* get(uint64_t hash, uint32_t num_pieces, const Moves& moves);
-	Entry* get(uint64_t hash, uint32_t num_pieces, const Player& player);
-};
+	// Permill of the entries used by the current search, estimated from the first buckets of the table
+	int hashfull() const;
+
+	void store(uint64_t hash, unsigned short best_move, uint8_t depth, nodeFlag node_flag, int16_t eval, uint8_t num_pieces);
 
-inline TranspositionTable tt; // Global Transposition Table
+	// Overwrites the entry of the position stored with num_pieces (if it is still in the table) with new_entry.
+	void replace(uint64_t hash, uint8_t num_pieces, const Entry& new_entry);
+
+	// Copies the entry of the position to entry, returns false if the position is not in the table.
+	// The move of the entry is only checked to be pseudo legal (see isPseudoLegal), callers check it with isLegal before playing it.
+	// Entries stored by the quiescence search can have no move (NULL_MOVE).
+	bool get(uint64_t hash, uint32_t num_pieces, const Player& player, Entry& entry);
+};
@@ -3,41 +3,32 @@
 #include "Position.h"
 #include <array>
 #include <bit>
-#include <climits>
-#include <random>
 
-static uint64_t addPiecesToHash(uint64_t hash, uint64_t piece_bitboard, uint64_t* piece_hash);
+static uint64_t addPiecesToHash(uint64_t hash, uint64_t piece_bitboard, const std::array<uint64_t, 64>& piece_hash);
 
-ZobristKeys::ZobristKeys() {
-	std::random_device rd;
-	std::default_random_engine generator(rd());
-	std::uniform_int_distribution<uint64_t> distribution(0, ULLONG_MAX);
+// SplitMix64, implemented here instead of using <random> since its engines and distributions vary between standard libraries
+static uint64_t nextRandom(uint64_t& state) {
+	uint64_t z = (state += 0x9e3779b97f4a7c15);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+	return z ^ (z >> 31);
+}
+
+ZobristKeys::ZobristKeys(uint64_t seed) : seed(seed) {
+	uint64_t state = seed;
 
-	for (auto& key : this->keys) {
-		key = distribution(generator);
+	for (std::array<uint64_t, 64>* piece_keys : { &white_pawn, &white_knight, &white_bishop, &white_rook, &white_queen, &white_king,
+												  &black_pawn, &black_knight, &black_bishop, &black_rook, &black_queen, &black_king }) {
+		for (uint64_t& key : *piece_keys) key = nextRandom(state);
 	}
 
-	white_pawn = &keys[0];
-	white_knight = &keys[64];
-	white_bishop = &keys[128];
-	white_rook = &keys[192];
-	white_queen = &keys[256];
-	white_king = &keys[320];
-
-	black_pawn = &keys[384];
-	black_knight = &keys[448];
-	black_bishop = &keys[512];
-	black_rook = &keys[576];
-	black_queen = &keys[640];
-	black_king = &keys[704];
-
-	en_passant_file = &keys[768];
-
-	is_black_to_move = distribution(generator);
-	white_castle_king_side = distribution(generator);
-	white_castle_queen_side= distribution(generator);
-	black_castle_king_side = distribution(generator);
-	black_castle_queen_side = distribution(generator);
+	for (uint64_t& key : en_passant_file) key = nextRandom(state);
+
+	is_black_to_move = nextRandom(state);
+	white_castle_king_side = nextRandom(state);
+	white_castle_queen_side = nextRandom(state);
+	black_castle_king_side = nextRandom(state);
+	black_castle_queen_side = nextRandom(state);
 }
 
 unsigned long long ZobristKeys::positionToHash(const Player& player, const Player& opponent) const {
@@ -74,7 +65,7 @@ unsigned long long ZobristKeys::positionToHash(const Player& player, const Playe
 	return hash;
 }
 
-static uint64_t addPiecesToHash(uint64_t hash, uint64_t piece_bitboard, uint64_t* piece_hash) {
+static uint64_t addPiecesToHash(uint64_t hash, uint64_t piece_bitboard, const std::array<uint64_t, 64>& piece_hash) {
 	
 	location loc = 0;
 	while (piece_bitboard != 0 && loc <= 63) {
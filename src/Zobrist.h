@@ -3,25 +3,28 @@
 #include <array>
 #include <cstdint>
 
-class ZobristKeys {
-	std::array<uint64_t, 776> keys = {};
+// Keys are the same in every run and build of the engine for the same seed, so hashes can be saved and loaded (see TranspositionTable::save)
+constexpr uint64_t default_zobrist_seed = 0x5eed0f2b1d3c4a97;
 
+class ZobristKeys {
 public:
-	uint64_t* white_pawn;
-	uint64_t* white_knight;
-	uint64_t* white_bishop;
-	uint64_t* white_rook;
-	uint64_t* white_queen;
-	uint64_t* white_king;
-
-	uint64_t* black_pawn;
-	uint64_t* black_knight;
-	uint64_t* black_bishop;
-	uint64_t* black_rook;
-	uint64_t* black_queen;
-	uint64_t* black_king;
-
-	uint64_t* en_passant_file;
+	uint64_t seed;
+
+	std::array<uint64_t, 64> white_pawn;
+	std::array<uint64_t, 64> white_knight;
+	std::array<uint64_t, 64> white_bishop;
+	std::array<uint64_t, 64> white_rook;
+	std::array<uint64_t, 64> white_queen;
+	std::array<uint64_t, 64> white_king;
+
+	std::array<uint64_t, 64> black_pawn;
+	std::array<uint64_t, 64> black_knight;
+	std::array<uint64_t, 64> black_bishop;
+	std::array<uint64_t, 64> black_rook;
+	std::array<uint64_t, 64> black_queen;
+	std::array<uint64_t, 64> black_king;
+
+	std::array<uint64_t, 8> en_passant_file;
 
 	uint64_t is_black_to_move;
 	uint64_t white_castle_king_side;
@@ -29,7 +32,7 @@ public:
 	uint64_t black_castle_king_side;
 	uint64_t black_castle_queen_side;
 
-	ZobristKeys();
+	ZobristKeys(uint64_t seed = default_zobrist_seed);
 
 	unsigned long long positionToHash(const Player& player, const Player& opponent) const;
 };
@@ -1,3 +1,4 @@
+#include "Bench.h"
 #include "BitBoards.h"
 #include "Engine.h"
 #include "GameMode.h"
@@ -14,6 +15,7 @@
 #include "EvaluateNNUE.h"
 #include <algorithm>
 #include <chrono>
+#include <cstring>
 #include <iostream>
 #include <limits>
 #include <string>
@@ -31,6 +33,17 @@ int main(int argc, char* argv[]) {
 		return 1;
 	}
 
+	// Same as the bench command, so that it can be run without a GUI: ChessEngine bench [depth] [threads] [hash]
+	if (argc > 1 && !strcmp("bench", argv[1])) {
+		try {
+			bench((argc > 2) ? std::stoi(argv[2]) : default_bench_depth, (argc > 3) ? std::stoi(argv[3]) : 1,
+				  (argc > 4) ? std::stoi(argv[4]) : default_bench_hash_mb);
+		}
+		catch (std::exception const& e) { cout << "Invalid arguments for bench.\n"; return 1; }
+
+		return 0;
+	}
+
 	if (enable_game_mode) {
 		Flags game_mode_flags = process_flags(argc, argv);
 
@@ -55,11 +68,42 @@ int main(int argc, char* argv[]) {
 		std::stringstream line(ln);
 		line >> command;
 
-		if (command == "uci") cout << "uciok" << '\n';
+		if (command == "uci") {
+			cout << "option name Hash type spin default " << default_tt_size_mb << " min 1 max " << max_tt_size_mb << '\n';
+			cout << "option name Clear Hash type button\n";
+			cout << "option name Threads type spin default 1 min 1 max " << max_threads << '\n';
+			cout << "uciok" << '\n';
+		}
 
 		else if (command == "isready") cout << "readyok\n";
 
-		else if (command == "ucinewgame") {}
+		else if (command == "ucinewgame") engine.clearHash();
+
+		else if (command == "setoption") {
+			std::string buffer, name, value;
+			line >> buffer; // name
+
+			while (line >> buffer && buffer != "value") name += (name.empty() ? "" : " ") + buffer;
+			line >> value;
+
+			if (name == "Threads") {
+				try { engine.setThreads(std::stoi(value)); }
+				catch (std::exception const& e) { cout << "Invalid value for option Threads: " << value << '\n'; }
+			}
+			else if (name == "Hash") {
+				try {
+					if (!engine.setHashSize(std::stoi(value)))
+						cout << "info string Could not allocate " << value << " MB for the hash, using " << engine.hashSizeMB() << " MB\n";
+				}
+				catch (std::exception const& e) { cout << "Invalid value for option Hash: " << value << '\n'; }
+			}
+			else if (name == "Clear Hash") {
+				engine.clearHash();
+			}
+			else {
+				cout << "Unknown option: " << name << '\n';
+			}
+		}
 
 		else if (command == "position") {
 			Position position = start_position;
@@ -133,6 +177,30 @@ int main(int argc, char* argv[]) {
 			engine.search();
 		}
 
+		else if (command == "bench") {
+			int depth = default_bench_depth, num_threads = 1, hash_size_mb = default_bench_hash_mb;
+			std::string buffer;
+
+			try {
+				if (line >> buffer) depth = std::stoi(buffer);
+				if (line >> buffer) num_threads = std::stoi(buffer);
+				if (line >> buffer) hash_size_mb = std::stoi(buffer);
+				bench(depth, num_threads, hash_size_mb);
+			}
+			catch (std::exception const& e) { cout << "Invalid value for bench: " << buffer << '\n'; }
+		}
+
+		// Not part of UCI, saves the transposition table to a file and loads it back after a restart
+		else if (command == "savehash" || command == "loadhash") {
+			std::string path;
+			std::getline(line >> std::ws, path);
+
+			if (path.empty()) cout << "Missing file path for " << command << '\n';
+			else if (command == "savehash") cout << (engine.saveHash(path) ? "Hash saved to " : "Could not save hash to ") << path << '\n';
+			else if (engine.loadHash(path)) cout << "Hash loaded from " << path << ", hash size is now " << engine.hashSizeMB() << " MB\n";
+			else cout << "Could not load hash from " << path << '\n';
+		}
+
 		else if (command == "stop") {
 			engine.stop();
 		}
@@ -1,112 +1,149 @@
 #include "Accumulator.h"
-#include "ClippedReLU.h"
 #include "InputNNUE.h"
-#include "LoadWeights.h"
+#include "Kernels.h"
+#include <algorithm>
 #include <bit>
 #include <cstdint>
-#include <immintrin.h>
 #include <string>
 #include <vector>
 
-Accumulator::Accumulator() {
-	bias = static_cast<int16_t*>(_mm_malloc(num_outputs_side * sizeof(int16_t), 32));
-	weights = static_cast<int16_t*>(_mm_malloc(num_inputs * num_outputs_side * sizeof(int16_t), 32));
+Accumulator::Accumulator(const AccumulatorWeights& accumulator_weights, const NNUEKernels& kernels) : kernels(kernels) {
+	bias = accumulator_weights.bias;
+	weights = accumulator_weights.weights;
 
-	added_pieces.reserve(10);
-	removed_pieces.reserve(10);
-}
+	stack.resize(accumulator_stack_size);
+
+	// Cache starts with empty boards
+	refresh_cache.resize(2 * 64);
+	if (bias == nullptr) return; // Network not loaded
 
-Accumulator::~Accumulator() {
-	_mm_free(bias);
-	_mm_free(weights);
+	for (AccumulatorCacheEntry& entry : refresh_cache)
+		std::copy(bias, bias + num_outputs_side, entry.arr);
 }
 
-void Accumulator::refresh() {
-	if (added_pieces.empty() && removed_pieces.empty()) return;
+void Accumulator::refresh(const Player& player, const Player& opponent) {
+	AccumulatorState& current = stack[ply];
 
-	for (int i = 0; i < num_outputs; i += 16) {
-		__m256i acc = _mm256_load_si256((__m256i*) & arr[i]);
+	for (bool white_perspective : { true, false }) {
+		if (current.computed[white_perspective]) continue;
 
-		for (auto& [p_weights_wk, p_weights_bk] : added_pieces) {
-			const int16_t* p_weights = (i < num_outputs_side) ? p_weights_wk : p_weights_bk - num_outputs_side;
+		// Find the closest ply with a computed accumulator, stopping at moves of the king of this perspective since every neuron changes then
+		int computed_ply = ply;
+		while (!stack[computed_ply].computed[white_perspective] && !stack[computed_ply].king_moved[white_perspective]) computed_ply--;
 
-			acc = _mm256_add_epi16(acc, _mm256_load_si256((__m256i*) & p_weights[i]));
+		if (stack[computed_ply].computed[white_perspective]) {
+			for (int i = computed_ply + 1; i <= ply; i++) update(stack[i - 1], stack[i], white_perspective);
+		}
+		else {
+			set(current, white_perspective, player, opponent);
 		}
+	}
 
-		for (auto& [p_weights_wk, p_weights_bk] : removed_pieces) {
-			const int16_t* p_weights = (i < num_outputs_side) ? p_weights_wk : p_weights_bk - num_outputs_side;
+	// Set pointers
+	side_to_move	 = player.is_white ? &current.arr[0] : &current.arr[num_outputs_side];
+	side_not_to_move = player.is_white ? &current.arr[num_outputs_side] : &current.arr[0];
+}
 
-			acc = _mm256_sub_epi16(acc, _mm256_load_si256((__m256i*) & p_weights[i]));
-		}
+void Accumulator::update(const AccumulatorState& previous, AccumulatorState& state, bool white_perspective) {
+	const int offset = white_perspective ? 0 : num_outputs_side;
 
-		_mm256_store_si256((__m256i*) & arr[i], acc);
-	}
+	const int16_t* added_weights[max_changed_pieces];
+	const int16_t* removed_weights[max_changed_pieces];
+
+	for (int j = 0; j < state.num_added; j++)
+		added_weights[j] = white_perspective ? state.added_pieces[j].p_weights_wk : state.added_pieces[j].p_weights_bk;
+
+	for (int j = 0; j < state.num_removed; j++)
+		removed_weights[j] = white_perspective ? state.removed_pieces[j].p_weights_wk : state.removed_pieces[j].p_weights_bk;
 
-	// Reset added and removed pieces
-	added_pieces.clear();
-	removed_pieces.clear();
+	kernels.update_accumulator(&previous.arr[offset], &state.arr[offset], added_weights, state.num_added, 
+							   removed_weights, state.num_removed, num_outputs_side);
+
+	state.computed[white_perspective] = true;
 }
 
 void Accumulator::set(const Player& player, const Player& opponent) {
-	std::vector<NNUEIndex> indexes = getIndexesNNUE(player, opponent);
+	ply = 0;
+	stack[0].king_moved[0] = stack[0].king_moved[1] = false;
+	set(stack[0], player, opponent);
+}
+
+void Accumulator::set(AccumulatorState& state, const Player& player, const Player& opponent) {
+	set(state, true, player, opponent);
+	set(state, false, player, opponent);
+}
 
-	// Add peices
-	for (int i = 0; i < num_outputs; i += 16) {
-		const int idx = (i < num_outputs_side) ? i : i - num_outputs_side;
-		__m256i acc = _mm256_load_si256((__m256i*) & bias[idx]);
+void Accumulator::set(AccumulatorState& state, bool white_perspective, const Player& player, const Player& opponent) {
+	const Player& white = player.is_white ? player : opponent;
+	const Player& black = player.is_white ? opponent : player;
 
-		for (auto& [index_wk, index_bk] : indexes) {
-			const int16_t* p_weights_sm  = weights + index_wk * num_outputs_side;
-			const int16_t* p_weights_snm = weights + index_bk * num_outputs_side;
+	location king_square = white_perspective ? white.locations.king : flip_square(black.locations.king);
+	AccumulatorCacheEntry& entry = refresh_cache[white_perspective * 64 + king_square];
 
-			const int16_t* p_weights = (i < num_outputs_side) ? p_weights_sm + i : p_weights_snm + i - num_outputs_side;
+	// Find pieces that changed since the accumulator of this king square was cached
+	const int16_t* added_weights[32];
+	const int16_t* removed_weights[32];
+	int num_added = 0, num_removed = 0;
 
-			acc = _mm256_add_epi16(acc, _mm256_load_si256((__m256i*) p_weights));
-		}
+	for (const Player* piece_owner : { &white, &black }) {
+		const BitBoards& bitboards = piece_owner->bitboards;
+		const uint64_t pieces[5] = { bitboards.pawns, bitboards.knights, bitboards.bishops, bitboards.rooks, bitboards.queens };
+
+		for (int piece_type = Pawn; piece_type <= Queen; piece_type++) {
+			uint64_t& cached_pieces = entry.pieces[piece_owner->is_white][piece_type];
+			uint64_t added   = pieces[piece_type] & ~cached_pieces;
+			uint64_t removed = cached_pieces & ~pieces[piece_type];
 
-		_mm256_store_si256((__m256i*) & arr[i], acc);
+			for (; added; added &= added - 1) {
+				int index = getIndexNNUE(king_square, std::countr_zero(added), PieceType(piece_type), piece_owner->is_white, white_perspective);
+				added_weights[num_added++] = weights + index * num_outputs_side;
+			}
+
+			for (; removed; removed &= removed - 1) {
+				int index = getIndexNNUE(king_square, std::countr_zero(removed), PieceType(piece_type), piece_owner->is_white, white_perspective);
+				removed_weights[num_removed++] = weights + index * num_outputs_side;
+			}
+
+			cached_pieces = pieces[piece_type];
+		}
 	}
 
-	// Reset pointers
-	side_to_move = player.is_white ? &arr[0] : &arr[num_outputs_side];
-	side_not_to_move = player.is_white ? &arr[num_outputs_side] : &arr[0];
+	// Update cache and copy it to the accumulator
+	kernels.update_accumulator(entry.arr, entry.arr, added_weights, num_added, removed_weights, num_removed, num_outputs_side);
+	std::copy(entry.arr, entry.arr + num_outputs_side, white_perspective ? &state.arr[0] : &state.arr[num_outputs_side]);
 
-	// Reset added and removed pieces
-	added_pieces.clear();
-	removed_pieces.clear();
+	state.computed[white_perspective] = true;
 }
 
-void Accumulator::flipSides() {
-	int16_t* tmp	 = side_to_move;
-	side_to_move	 = side_not_to_move;
-	side_not_to_move = tmp;
+void Accumulator::push() {
+	ply++;
+	if (ply == (int) stack.size()) stack.emplace_back();
+
+	AccumulatorState& state = stack[ply];
+	state.num_added	  = 0;
+	state.num_removed = 0;
+	state.computed[0]	= state.computed[1]   = false;
+	state.king_moved[0] = state.king_moved[1] = false;
 }
 
 void Accumulator::movePiece(PieceType piece_type, location initial_loc, location final_loc, const Player& player, const Player& opponent) {
 
-	// If king moves, we need to recalculate every neuron of the accumulator
+	// If king moves, we need to recalculate every neuron of the perspective of that king
 	if (piece_type == King) {
-		set(player, opponent);
+		stack[ply].king_moved[player.is_white] = true;
 		return;
 	}
 
-	auto [index_wk_add, index_bk_add] = getIndexNNUE(final_loc, piece_type, player, opponent);
-	auto [index_wk_rm, index_bk_rm]   = getIndexNNUE(initial_loc, piece_type, player, opponent);
-
-	const int16_t* p_weights_wk_add = weights + index_wk_add * num_outputs_side;
-	const int16_t* p_weights_bk_add = weights + index_bk_add * num_outputs_side;
-	const int16_t* p_weights_wk_rm  = weights + index_wk_rm  * num_outputs_side;
-	const int16_t* p_weights_bk_rm  = weights + index_bk_rm  * num_outputs_side;
-
-	added_pieces.emplace_back(p_weights_wk_add, p_weights_bk_add);
-	removed_pieces.emplace_back(p_weights_wk_rm, p_weights_bk_rm);
+	addPiece(piece_type, final_loc, player, opponent);
+	removePiece(piece_type, initial_loc, player, opponent);
 }
 
 void Accumulator::addPiece(PieceType piece_type, location loc, const Player& player, const Player& opponent) {
+	AccumulatorState& state = stack[ply];
 	
-	// If king moves, we need to recalculate every neuron of the accumulator
+	// If king moves, we need to recalculate every neuron of the perspective of that king
 	if (piece_type == King) {
-		set(player, opponent);
+		state.king_moved[player.is_white] = true;
 		return;
 	}
 	
@@ -115,14 +152,15 @@ void Accumulator::addPiece(PieceType piece_type, location loc, const Player& pla
 	const int16_t* p_weights_wk = weights + index_wk * num_outputs_side;
 	const int16_t* p_weights_bk = weights + index_bk * num_outputs_side;
 
-	added_pieces.emplace_back(p_weights_wk, p_weights_bk);
+	state.added_pieces[state.num_added++] = { p_weights_wk, p_weights_bk };
 }
 
 void Accumulator::removePiece(PieceType piece_type, location loc, const Player& player, const Player& opponent) {
+	AccumulatorState& state = stack[ply];
 
-	// If king moves, we need to recalculate every neuron of the accumulator
+	// If king moves, we need to recalculate every neuron of the perspective of that king
 	if (piece_type == King) {
-		set(player, opponent);
+		state.king_moved[player.is_white] = true;
 		return;
 	}
 
@@ -131,12 +169,5 @@ void Accumulator::removePiece(PieceType piece_type, location loc, const Player&
 	const int16_t* p_weights_wk = weights + index_wk * num_outputs_side;
 	const int16_t* p_weights_bk = weights + index_bk * num_outputs_side;
 
-	removed_pieces.emplace_back(p_weights_wk, p_weights_bk);
-}
-
-bool Accumulator::setWeights(std::filesystem::path file_biases, std::filesystem::path file_weights) {
-	bool loaded_bias    = loadFromFile(bias, num_outputs_side, file_biases);
-	bool loaded_weights = loadFromFile(weights, num_inputs * num_outputs_side, file_weights);
-
-	return loaded_bias && loaded_weights;
+	state.removed_pieces[state.num_removed++] = { p_weights_wk, p_weights_bk };
 }
@@ -2,41 +2,90 @@
 #include "PieceTypes.h"
 #include "Player.h"
 #include <cstdint>
-#include <filesystem>
 #include <vector>
 
 constexpr int num_inputs = 64 * 64 * 10;
 constexpr int num_outputs = 512;
 constexpr int num_outputs_side = num_outputs / 2;
 
+struct NNUEKernels;
+
 struct weights_P {
     const int16_t *p_weights_wk, *p_weights_bk;
 };
 
+// Weights of the accumulator, inside the mapped network file, shared (read only) by the accumulators of every search thread
+struct AccumulatorWeights {
+    const int16_t*  bias    = nullptr;
+    const int16_t*  weights = nullptr;
+};
+
+// At most 2 pieces are removed (en passant, promotion with capture) and 1 is added by a move, besides the king
+constexpr int max_changed_pieces = 2;
+
+// Initial capacity of the accumulator stack, it only grows if the search goes deeper than that
+constexpr int accumulator_stack_size = 128;
+
+/*
+    Accumulator of a position in the search, computed lazily from the accumulator of the previous ply. Each perspective
+    is computed independently, since a king move only changes the inputs of the perspective of that king, so the other
+    perspective can still be updated incrementally. Flags are indexed by [is white perspective].
+*/
+struct AccumulatorState {
+    alignas(32) int16_t arr[num_outputs];
+
+    weights_P   added_pieces[max_changed_pieces];
+    weights_P   removed_pieces[max_changed_pieces];
+    uint8_t     num_added       = 0;
+    uint8_t     num_removed     = 0;
+    bool        computed[2]     = {};
+    bool        king_moved[2]   = {};
+};
+
+/*
+	Refresh cache: accumulator of a single perspective and the pieces it was computed with, for each square of the
+	king of that perspective. When the king moves, only the pieces that changed since the last time the king was on
+	the same square need to be added or removed, instead of computing the accumulator from all pieces on the board.
+*/
+struct AccumulatorCacheEntry {
+    alignas(32) int16_t arr[num_outputs_side];
+    uint64_t            pieces[2][5] = {}; // Bitboards of the pieces (without kings) indexed by [is white][piece type]
+};
+
 struct alignas(32) Accumulator {
 private:
-    int16_t*    bias;
-    int16_t*    weights;
-    int16_t 	arr[num_outputs] = {};
+    const int16_t*                  bias;
+    const int16_t*                  weights;
+    const NNUEKernels&              kernels;
+    std::vector<AccumulatorState>   stack;
+    int                             ply = 0;
 
-    std::vector<weights_P> added_pieces   = {};
-    std::vector<weights_P> removed_pieces = {};
+    std::vector<AccumulatorCacheEntry> refresh_cache; // Indexed by [is white perspective][king square]
+
+    void set(AccumulatorState& state, const Player& player, const Player& opponent);
+    void set(AccumulatorState& state, bool white_perspective, const Player& player, const Player& opponent);
+    void update(const AccumulatorState& previous, AccumulatorState& state, bool white_perspective);
 
 public:
-    int8_t 		quant_arr[num_outputs]  = {};
-    int16_t*    side_to_move            = &arr[0];
-    int16_t*    side_not_to_move        = &arr[num_outputs_side];
+    alignas(32) int8_t 	quant_arr[num_outputs]  = {};
+    const int16_t*      side_to_move            = nullptr;
+    const int16_t*      side_not_to_move        = nullptr;
+
+    Accumulator(const AccumulatorWeights& accumulator_weights, const NNUEKernels& kernels);
 
-    Accumulator();
-    ~Accumulator();
+    // Computes the accumulator of the current ply (if needed) and sets the pointers to each side, player is the side to move
+    void refresh(const Player& player, const Player& opponent);
 
-    void refresh();
+    // Sets the root position, clearing the stack
     void set(const Player& player, const Player& opponent);
 
-    void flipSides();
+    // Called before making a move, changes of the move are recorded in the new ply
+    void push();
+
+    // Called when unmaking a move, returning to the accumulator of the previous ply
+    inline void pop() { ply--; }
+
     void movePiece(PieceType piece_type, location initial_loc, location final_loc, const Player& player, const Player& opponent);
     void addPiece(PieceType piece_type, location loc, const Player& player, const Player& opponent);
     void removePiece(PieceType piece_type, location loc, const Player& player, const Player& opponent);
-
-    bool setWeights(std::filesystem::path file_biases, std::filesystem::path file_weights);
 };
@@ -1,5 +0,0 @@
-#pragma once
-#include <cstdint>
-
-void crelu(const int16_t* input, int8_t* output, int size);
-void crelu(const int32_t* input, int8_t* output, int size);
@@ -1,40 +1,82 @@
 #include "EvaluateNNUE.h"
+#include "EmbeddedData.h"
 #include "Player.h"
 #include "Accumulator.h"
-#include "ClippedReLU.h"
+#include "Kernels.h"
 #include "LinearLayer.h"
+#include "NetworkFile.h"
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <filesystem>
+#include <span>
+
+NetworkWeights::NetworkWeights() {
+	std::span<const uint8_t> embedded_network = embeddedNetwork();
+	if (!embedded_network.empty()) {
+		loadFromMemory(embedded_network.data(), embedded_network.size());
+		return;
+	}
 
-NNUE::NNUE() {
 	std::filesystem::path weights_dir = std::filesystem::path(__FILE__).parent_path().parent_path() / "Weights";
 
-	bool loaded = accumulator.setWeights(weights_dir / "accb.bin", weights_dir / "accw.bin");
-	loaded &= hidden_layer1.setWeights(weights_dir / "lin1b.bin", weights_dir / "lin1w.bin");
-	loaded &= hidden_layer2.setWeights(weights_dir / "lin2b.bin", weights_dir / "lin2w.bin");
-	loaded &= hidden_layer3.setWeights(weights_dir / "lin3b.bin", weights_dir / "lin3w.bin");
+	if (!load(default_network_file)) load(weights_dir / default_network_file);
+}
+
+bool NetworkWeights::load(const std::filesystem::path& path) {
+	loaded = false;
+	if (!file.open(path)) return false;
+
+	if (!loadFromMemory(file.data(), file.size())) {
+		file.close();
+		return false;
+	}
+
+	return true;
+}
+
+bool NetworkWeights::loadFromMemory(const uint8_t* data, size_t size) {
+	loaded = false;
+
+	const LayerShape expected_layers[num_network_layers] = {
+		{ num_inputs, num_outputs_side },
+		{ (uint32_t) hidden_layer1.getNumInputs(), (uint32_t) hidden_layer1.getNumOutputs() },
+		{ (uint32_t) hidden_layer2.getNumInputs(), (uint32_t) hidden_layer2.getNumOutputs() },
+		{ (uint32_t) hidden_layer3.getNumInputs(), (uint32_t) hidden_layer3.getNumOutputs() },
+	};
+
+	const NetworkFileHeader* header = validateNetworkFile(data, size, expected_layers);
+	if (header == nullptr) return false;
+
+	auto section = [&](int i) { return data + header->sections[i].offset; };
+
+	accumulator.bias	= reinterpret_cast<const int16_t*>(section(0));
+	accumulator.weights = reinterpret_cast<const int16_t*>(section(1));
+	hidden_layer1.setWeights(reinterpret_cast<const int32_t*>(section(2)), reinterpret_cast<const int8_t*>(section(3)));
+	hidden_layer2.setWeights(reinterpret_cast<const int32_t*>(section(4)), reinterpret_cast<const int8_t*>(section(5)));
+	hidden_layer3.setWeights(reinterpret_cast<const int32_t*>(section(6)), reinterpret_cast<const int8_t*>(section(7)));
 
-	this->loaded = loaded;
+	loaded = true;
+	return true;
 }
 
-int NNUE::evaluate() {
-	accumulator.refresh();
+int NNUE::evaluate(const Player& player, const Player& opponent) {
+	accumulator.refresh(player, opponent);
 
 	// Quantitize accumulator
-	crelu(accumulator.side_to_move, accumulator.quant_arr, 256);
-	crelu(accumulator.side_not_to_move, accumulator.quant_arr + 256, 256);
+	kernels.crelu_16(accumulator.side_to_move, accumulator.quant_arr, 256);
+	kernels.crelu_16(accumulator.side_not_to_move, accumulator.quant_arr + 256, 256);
 
 	// First hidden layer
-	hidden_layer1.processLinearLayer(accumulator.quant_arr, hidden_neuros1);
-	crelu(hidden_neuros1, quant_hidden_neuros1, 32);
+	network_weights.hidden_layer1.processLinearLayer(kernels, accumulator.quant_arr, hidden_neuros1);
+	kernels.crelu_32(hidden_neuros1, quant_hidden_neuros1, 32);
 
 	// Second hidden layer
-	hidden_layer2.processLinearLayer(quant_hidden_neuros1, hidden_neuros2);
-	crelu(hidden_neuros2, quant_hidden_neuros2, 32);
+	network_weights.hidden_layer2.processLinearLayer(kernels, quant_hidden_neuros1, hidden_neuros2);
+	kernels.crelu_32(hidden_neuros2, quant_hidden_neuros2, 32);
 
 	// Output layer
-	hidden_layer3.processLinearLayer(quant_hidden_neuros2, &output_neuron);
+	network_weights.hidden_layer3.processLinearLayer(kernels, quant_hidden_neuros2, &output_neuron);
 
 	return output_neuron;
 }
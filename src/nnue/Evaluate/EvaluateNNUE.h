@@ -1,33 +1,71 @@
 #pragma once
 #include "Player.h"
 #include "Accumulator.h"
-#include "ClippedReLU.h"
+#include "Kernels.h"
 #include "LinearLayer.h"
+#include "MappedFile.h"
 #include "PieceTypes.h"
+#include <cstddef>
 #include <cstdint>
+#include <filesystem>
+
+/*
+	Network file (see NetworkFile.h) loaded at startup, the one embedded in the binary if it was built with EMBED_DATA,
+	otherwise searched in the working directory and then in the Weights directory.
+*/
+constexpr const char* default_network_file = "nnue.bin";
+
+// Weights of the network, mapped once and shared (read only) by the NNUE of every search thread and every engine process
+struct NetworkWeights {
+	MappedFile				file;
+	AccumulatorWeights		accumulator					= AccumulatorWeights();
+	LinearLayer				hidden_layer1				= LinearLayer(512, 32);
+	LinearLayer				hidden_layer2				= LinearLayer(32, 32);
+	LinearLayer				hidden_layer3				= LinearLayer(32, 1);
+
+	bool loaded = false;
+
+	NetworkWeights();
+
+	// Maps a network file, returns false (and leaves no network loaded) if it is missing or not valid
+	bool load(const std::filesystem::path& path);
+
+	// Uses the weights of a network file in memory, which must outlive the network
+	bool loadFromMemory(const uint8_t* data, size_t size);
+};
+
+inline NetworkWeights network_weights = NetworkWeights(); // Global network weights
 
 class NNUE {
-	Accumulator				accumulator					= Accumulator();
+	const NNUEKernels&		kernels;
+	Accumulator				accumulator;
 	alignas(64) int32_t		hidden_neuros1[32]			= {};
 	alignas(64) int8_t		quant_hidden_neuros1[32]	= {};
-	LinearLayer				hidden_layer1				= LinearLayer(512, 32);
 	alignas(64) int32_t		hidden_neuros2[32]			= {};
 	alignas(64) int8_t		quant_hidden_neuros2[32]	= {};
-	LinearLayer				hidden_layer2				= LinearLayer(32, 32);
 	int32_t					output_neuron				= 0;
-	LinearLayer				hidden_layer3				= LinearLayer(32, 1);
-
-	bool loaded = false;
 
 public:
-	NNUE();
+	// Picks the fastest kernels supported by the CPU
+	NNUE() : kernels(selectNNUEKernels()), accumulator(network_weights.accumulator, kernels) {}
 
-	int evaluate();
+	// Evaluation of the position for the side to move (player)
+	int evaluate(const Player& player, const Player& opponent);
 
 	inline void setPosition(const Player& player, const Player& opponent) {
 		accumulator.set(player, opponent);
 	}
 
+	// Called before making a move
+	inline void push() {
+		accumulator.push();
+	}
+
+	// Called when unmaking a move, no work is needed to restore the accumulator
+	inline void pop() {
+		accumulator.pop();
+	}
+
 	inline void movePiece(PieceType piece_type, location initial_loc, location final_loc, const Player& player, const Player& opponent) {
 		accumulator.movePiece(piece_type, initial_loc, final_loc, player, opponent);
 	}
@@ -40,11 +78,5 @@ public:
 		accumulator.removePiece(piece_type, loc, player, opponent);
 	}
 
-	inline void flipSides() {
-		accumulator.flipSides();
-	}
-
-	inline bool is_loaded() const { return loaded; }
+	inline bool is_loaded() const { return network_weights.loaded; }
 };
-
-inline NNUE nnue = NNUE(); // Global NNUE
@@ -44,5 +44,13 @@ inline int flip_square(int square) {
 	return (56 - square + 2 * file);
 }
 
+// Index of the input of a piece in a single perspective, king_square is the square of the king of that perspective (flipped for black)
+inline int getIndexNNUE(location king_square, location square, PieceType piece_type, bool piece_is_white, bool white_perspective) {
+	int loc = white_perspective ? square : flip_square(square);
+	int offset = (piece_is_white != white_perspective) ? 64 : 0;
+
+	return king_square * 10 * 64 + 2 * 64 * piece_type + loc + offset;
+}
+
 NNUEIndex getIndexNNUE(location square, PieceType piece_type, const Player& player, const Player& opponent);
 std::vector<NNUEIndex> getIndexesNNUE(const Player& player, const Player& opponent);
@@ -0,0 +1,59 @@
+#include "Kernels.h"
+#include "CpuFeatures.h"
+
+#ifdef PORTABLE_KERNELS
+const NNUEKernels scalar_kernels = {
+	"scalar",
+	creluScalar,
+	creluScalar,
+	processLinearLayerScalar,
+	updateAccumulatorScalar
+};
+
+const NNUEKernels sse41_kernels = {
+	"SSE4.1",
+	creluSSE41,
+	creluSSE41,
+	processLinearLayerSSE41,
+	updateAccumulatorSSE41
+};
+#endif
+
+const NNUEKernels avx2_kernels = {
+	"AVX2",
+	creluAVX2,
+	creluAVX2,
+	processLinearLayerAVX2,
+	updateAccumulatorAVX2
+};
+
+// Layers after the accumulator are too small to fill a 512 bit register, so the AVX2 version of crelu is used for them
+const NNUEKernels avx512bw_kernels = {
+	"AVX-512BW",
+	creluAVX512,
+	creluAVX2,
+	processLinearLayerAVX512BW,
+	updateAccumulatorAVX512
+};
+
+const NNUEKernels avx512vnni_kernels = {
+	"AVX-512 VNNI",
+	creluAVX512,
+	creluAVX2,
+	processLinearLayerAVX512VNNI,
+	updateAccumulatorAVX512
+};
+
+const NNUEKernels& selectNNUEKernels() {
+	const CpuFeatures& cpu = cpuFeatures();
+
+	if (cpu.avx512vnni) return avx512vnni_kernels;
+	if (cpu.avx512bw)	return avx512bw_kernels;
+#ifdef PORTABLE_KERNELS
+	if (cpu.avx2)		return avx2_kernels;
+	if (cpu.sse41)		return sse41_kernels;
+	return scalar_kernels;
+#else
+	return avx2_kernels;
+#endif
+}
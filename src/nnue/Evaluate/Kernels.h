@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+
+/*
+	SIMD kernels used in the inference of the NNUE, there is one version for each instruction set, and the fastest one
+	supported by the CPU is picked at runtime when a NNUE is constructed. Each version is in its own translation unit,
+	compiled with the flags of its instruction set. Scalar and SSE4.1 versions are only built with PORTABLE_KERNELS
+	(CMake option), without them the binary requires AVX2.
+
+	All versions give the same results:
+		- crelu clamps the input to [0, 127].
+		- linear_layer computes ((weights * input) + bias) / scaling_weights, with the input in [0, 127].
+		- update_accumulator computes input + sum(added) - sum(removed), with 16 bit wrap around.
+*/
+struct NNUEKernels {
+	const char* name;
+
+	void (*crelu_16)(const int16_t* input, int8_t* output, int size);
+	void (*crelu_32)(const int32_t* input, int8_t* output, int size);
+
+	void (*linear_layer)(const int8_t* input, int32_t* output, const int8_t* weights, const int32_t* bias, int num_inputs, int num_outputs);
+
+	void (*update_accumulator)(const int16_t* input, int16_t* output, const int16_t* const* added, int num_added,
+							   const int16_t* const* removed, int num_removed, int size);
+};
+
+// Fastest kernels supported by the CPU
+const NNUEKernels& selectNNUEKernels();
+
+extern const NNUEKernels scalar_kernels;
+extern const NNUEKernels sse41_kernels;
+extern const NNUEKernels avx2_kernels;
+extern const NNUEKernels avx512bw_kernels;
+extern const NNUEKernels avx512vnni_kernels;
+
+// Scalar (also auto vectorized to SSE2 on x86-64)
+void creluScalar(const int16_t* input, int8_t* output, int size);
+void creluScalar(const int32_t* input, int8_t* output, int size);
+void processLinearLayerScalar(const int8_t* input, int32_t* output, const int8_t* weights, const int32_t* bias, int num_inputs, int num_outputs);
+void updateAccumulatorScalar(const int16_t* input, int16_t* output, const int16_t* const* added, int num_added,
+							 const int16_t* const* removed, int num_removed, int size);
+
+// SSE4.1
+void creluSSE41(const int16_t* input, int8_t* output, int size);
+void creluSSE41(const int32_t* input, int8_t* output, int size);
+void processLinearLayerSSE41(const int8_t* input, int32_t* output, const int8_t* weights, const int32_t* bias, int num_inputs, int num_outputs);
+void updateAccumulatorSSE41(const int16_t* input, int16_t* output, const int16_t* const* added, int num_added,
+							const int16_t* const* removed, int num_removed, int size);
+
+// AVX2
+void creluAVX2(const int16_t* input, int8_t* output, int size);
+void creluAVX2(const int32_t* input, int8_t* output, int size);
+void processLinearLayerAVX2(const int8_t* input, int32_t* output, const int8_t* weights, const int32_t* bias, int num_inputs, int num_outputs);
+void updateAccumulatorAVX2(const int16_t* input, int16_t* output, const int16_t* const* added, int num_added,
+						   const int16_t* const* removed, int num_removed, int size);
+
+// AVX-512 (F, BW and VL), VNNI version of the linear layer uses vpdpbusd
+void creluAVX512(const int16_t* input, int8_t* output, int size);
+void processLinearLayerAVX512BW(const int8_t* input, int32_t* output, const int8_t* weights, const int32_t* bias, int num_inputs, int num_outputs);
+void processLinearLayerAVX512VNNI(const int8_t* input, int32_t* output, const int8_t* weights, const int32_t* bias, int num_inputs, int num_outputs);
+void updateAccumulatorAVX512(const int16_t* input, int16_t* output, const int16_t* const* added, int num_added,
+							 const int16_t* const* removed, int num_removed, int size);
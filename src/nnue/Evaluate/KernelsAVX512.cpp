@@ -0,0 +1,163 @@
+#include "Kernels.h"
+#include "LinearLayer.h"
+#include <cassert>
+#include <cstdint>
+#include <immintrin.h>
+
+// Sum of the 8 i32s of the register
+inline int32_t horizontalSum(__m256i x) {
+	const __m128i sum_128 = _mm_add_epi32(_mm256_castsi256_si128(x), _mm256_extracti128_si256(x, 1));
+	const __m128i sum_64  = _mm_add_epi32(sum_128, _mm_shuffle_epi32(sum_128, 0b01001110));
+	const __m128i sum_32  = _mm_add_epi32(sum_64, _mm_shuffle_epi32(sum_64, 0b10110001));
+	return _mm_cvtsi128_si32(sum_32);
+}
+
+/*
+	Halves of a 512 bit register. The zero masked extract is used instead of the cast and the plain extract (and the
+	same for the permute and broadcast below), since GCC 12 implements those with an undefined register as the unused
+	source, which makes it warn that the register may be used uninitialized. With a full mask the instruction is the same.
+*/
+inline __m256i lowerHalf(__m512i x) { return _mm512_maskz_extracti64x4_epi64(0xff, x, 0); }
+inline __m256i upperHalf(__m512i x) { return _mm512_maskz_extracti64x4_epi64(0xff, x, 1); }
+
+// Sum of the 16 i32s of the register
+inline int32_t horizontalSum(__m512i x) {
+	return horizontalSum(_mm256_add_epi32(lowerHalf(x), upperHalf(x)));
+}
+
+/*
+	(64 u8s) * (64 i8s) -> (16 i32s), added to the accumulator.
+	Input will always be positive because of the activation function, so it can be passed as the unsigned operand.
+	VNNI does it in a single instruction (vpdpbusd), otherwise neighbour results are added with maddubs (no saturation,
+	since 127 * 128 * 2 fits in an i16) and then converted to i32s with madd.
+*/
+template <bool vnni>
+inline __m512i dotProduct(__m512i accumulator, __m512i input, __m512i weights) {
+	if constexpr (vnni) {
+		return _mm512_dpbusd_epi32(accumulator, input, weights);
+	}
+	else {
+		const __m512i result = _mm512_madd_epi16(_mm512_maddubs_epi16(input, weights), _mm512_set1_epi16(1));
+		return _mm512_add_epi32(accumulator, result);
+	}
+}
+
+template <bool vnni>
+inline __m256i dotProduct(__m256i accumulator, __m256i input, __m256i weights) {
+	if constexpr (vnni) {
+		return _mm256_dpbusd_epi32(accumulator, input, weights);
+	}
+	else {
+		const __m256i result = _mm256_madd_epi16(_mm256_maddubs_epi16(input, weights), _mm256_set1_epi16(1));
+		return _mm256_add_epi32(accumulator, result);
+	}
+}
+
+void creluAVX512(const int16_t* input, int8_t* output, int size) {
+	assert(size % 32 == 0, "Size must be a multiple of 32.");
+
+	const __m512i zeros = _mm512_setzero_si512();
+	const __m512i idx = _mm512_set_epi64(7, 5, 3, 1, 6, 4, 2, 0);
+
+	int i = 0;
+	for (; i + 64 <= size; i += 64) {
+		const __m512i inp_0 = _mm512_loadu_si512(&input[i +  0]);
+		const __m512i inp_1 = _mm512_loadu_si512(&input[i + 32]);
+
+		// Same as the AVX2 version, packs works in each 128 bit lane, so the result is in the following order
+		// (in 64 bit blocks): 0, 4, 1, 5, 2, 6, 3, 7
+		const __m512i packed = _mm512_max_epi8(_mm512_packs_epi16(inp_0, inp_1), zeros);
+		const __m512i result = _mm512_maskz_permutexvar_epi64(0xff, idx, packed); // change the order to the original one
+
+		_mm512_storeu_si512(&output[i], result);
+	}
+
+	if (i < size) creluAVX2(input + i, output + i, size - i);
+}
+
+template <bool vnni>
+void processLinearLayerAVX512(const int8_t* input, int32_t* output, const int8_t* weights, const int32_t* bias, int num_inputs, int num_outputs) {
+
+	assert(num_inputs % 32 == 0, "Number of input neurons has to be a multiple of 32.");
+	assert((num_outputs % 4 == 0) || (num_outputs == 1), "Number of output neurons has to be a multiple of 4 (except output layer).");
+
+	if (num_outputs == 1) {
+		__m256i accumulator = _mm256_setzero_si256();
+
+		for (int j = 0; j < num_inputs; j += 32)
+			accumulator = dotProduct<vnni>(accumulator, _mm256_loadu_si256((__m256i*) &input[j]), _mm256_loadu_si256((__m256i*) &weights[j]));
+
+		output[0] = (horizontalSum(accumulator) + bias[0]) >> log_scaling_weights;
+	}
+	else if (num_inputs % 64 == 0) {
+		// Calculate 4 outputs at a time, as in the AVX2 version
+		for (int i = 0; i < num_outputs; i += 4) {
+			const int8_t* const weights_0 = weights + (i + 0) * num_inputs;
+			const int8_t* const weights_1 = weights + (i + 1) * num_inputs;
+			const int8_t* const weights_2 = weights + (i + 2) * num_inputs;
+			const int8_t* const weights_3 = weights + (i + 3) * num_inputs;
+
+			__m512i accumulator_0 = _mm512_setzero_si512();
+			__m512i accumulator_1 = _mm512_setzero_si512();
+			__m512i accumulator_2 = _mm512_setzero_si512();
+			__m512i accumulator_3 = _mm512_setzero_si512();
+
+			for (int j = 0; j < num_inputs; j += 64) {
+				const __m512i inp = _mm512_loadu_si512(&input[j]);
+
+				accumulator_0 = dotProduct<vnni>(accumulator_0, inp, _mm512_loadu_si512(&weights_0[j]));
+				accumulator_1 = dotProduct<vnni>(accumulator_1, inp, _mm512_loadu_si512(&weights_1[j]));
+				accumulator_2 = dotProduct<vnni>(accumulator_2, inp, _mm512_loadu_si512(&weights_2[j]));
+				accumulator_3 = dotProduct<vnni>(accumulator_3, inp, _mm512_loadu_si512(&weights_3[j]));
+			}
+
+			output[i + 0] = (horizontalSum(accumulator_0) + bias[i + 0]) >> log_scaling_weights;
+			output[i + 1] = (horizontalSum(accumulator_1) + bias[i + 1]) >> log_scaling_weights;
+			output[i + 2] = (horizontalSum(accumulator_2) + bias[i + 2]) >> log_scaling_weights;
+			output[i + 3] = (horizontalSum(accumulator_3) + bias[i + 3]) >> log_scaling_weights;
+		}
+	}
+	else {
+		// Inputs don't fill a 512 bit register, but two outputs do, so calculate them together
+		assert(num_inputs == 32, "Number of input neurons has to be a multiple of 64 or 32.");
+
+		const __m256i inp_256 = _mm256_loadu_si256((__m256i*) input);
+		const __m512i inp = _mm512_maskz_broadcast_i64x4(0xff, inp_256);
+
+		for (int i = 0; i < num_outputs; i += 4) {
+			// Weights of 2 consecutive outputs are next to each other
+			const __m512i accumulator_01 = dotProduct<vnni>(_mm512_setzero_si512(), inp, _mm512_loadu_si512(&weights[(i + 0) * 32]));
+			const __m512i accumulator_23 = dotProduct<vnni>(_mm512_setzero_si512(), inp, _mm512_loadu_si512(&weights[(i + 2) * 32]));
+
+			output[i + 0] = (horizontalSum(lowerHalf(accumulator_01)) + bias[i + 0]) >> log_scaling_weights;
+			output[i + 1] = (horizontalSum(upperHalf(accumulator_01)) + bias[i + 1]) >> log_scaling_weights;
+			output[i + 2] = (horizontalSum(lowerHalf(accumulator_23)) + bias[i + 2]) >> log_scaling_weights;
+			output[i + 3] = (horizontalSum(upperHalf(accumulator_23)) + bias[i + 3]) >> log_scaling_weights;
+		}
+	}
+}
+
+void processLinearLayerAVX512BW(const int8_t* input, int32_t* output, const int8_t* weights, const int32_t* bias, int num_inputs, int num_outputs) {
+	processLinearLayerAVX512<false>(input, output, weights, bias, num_inputs, num_outputs);
+}
+
+void processLinearLayerAVX512VNNI(const int8_t* input, int32_t* output, const int8_t* weights, const int32_t* bias, int num_inputs, int num_outputs) {
+	processLinearLayerAVX512<true>(input, output, weights, bias, num_inputs, num_outputs);
+}
+
+void updateAccumulatorAVX512(const int16_t* input, int16_t* output, const int16_t* const* added, int num_added,
+							 const int16_t* const* removed, int num_removed, int size) {
+	assert(size % 32 == 0, "Size must be a multiple of 32.");
+
+	for (int i = 0; i < size; i += 32) {
+		__m512i acc = _mm512_loadu_si512(&input[i]);
+
+		for (int j = 0; j < num_added; j++)
+			acc = _mm512_add_epi16(acc, _mm512_loadu_si512(&added[j][i]));
+
+		for (int j = 0; j < num_removed; j++)
+			acc = _mm512_sub_epi16(acc, _mm512_loadu_si512(&removed[j][i]));
+
+		_mm512_storeu_si512(&output[i], acc);
+	}
+}
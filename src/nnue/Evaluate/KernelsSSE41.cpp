@@ -0,0 +1,118 @@
+#include "Kernels.h"
+#include "LinearLayer.h"
+#include <cassert>
+#include <cstdint>
+#include <immintrin.h>
+
+// Same as the AVX2 version with 128 bit registers, packs does not cross lanes so no reordering is needed
+void creluSSE41(const int16_t* input, int8_t* output, int size) {
+	assert(size % 16 == 0, "Size must be a multiple of 16.");
+
+	const __m128i zeros = _mm_setzero_si128();
+
+	for (int i = 0; i < size; i += 16) {
+		const __m128i inp_0 = _mm_load_si128((__m128i*) &input[i + 0]);
+		const __m128i inp_1 = _mm_load_si128((__m128i*) &input[i + 8]);
+
+		const __m128i result = _mm_max_epi8(_mm_packs_epi16(inp_0, inp_1), zeros);
+
+		_mm_store_si128((__m128i*) &output[i], result);
+	}
+}
+
+void creluSSE41(const int32_t* input, int8_t* output, int size) {
+	assert(size % 16 == 0, "Size must be a multiple of 16.");
+
+	const __m128i zeros = _mm_setzero_si128();
+
+	for (int i = 0; i < size; i += 16) {
+		const __m128i inp_0 = _mm_load_si128((__m128i*) &input[i +  0]);
+		const __m128i inp_1 = _mm_load_si128((__m128i*) &input[i +  4]);
+		const __m128i inp_2 = _mm_load_si128((__m128i*) &input[i +  8]);
+		const __m128i inp_3 = _mm_load_si128((__m128i*) &input[i + 12]);
+
+		const __m128i packed_1 = _mm_packs_epi32(inp_0, inp_1);
+		const __m128i packed_2 = _mm_packs_epi32(inp_2, inp_3);
+		const __m128i result   = _mm_max_epi8(_mm_packs_epi16(packed_1, packed_2), zeros);
+
+		_mm_store_si128((__m128i*) &output[i], result);
+	}
+}
+
+void processLinearLayerSSE41(const int8_t* input, int32_t* output, const int8_t* weights, const int32_t* bias, int num_inputs, int num_outputs) {
+
+	assert(num_inputs % 16 == 0, "Number of input neurons has to be a multiple of 16.");
+	assert((num_outputs % 4 == 0) || (num_outputs == 1), "Number of output neurons has to be a multiple of 4 (except output layer).");
+
+	const __m128i ones = _mm_set1_epi16(1);
+
+	if (num_outputs == 1) {
+		__m128i accumulator = _mm_setzero_si128();
+
+		for (int j = 0; j < num_inputs; j += 16) {
+			const __m128i inp = _mm_load_si128((__m128i*) &input[j]);
+			const __m128i result = _mm_madd_epi16(_mm_maddubs_epi16(inp, _mm_load_si128((__m128i*) &weights[j])), ones);
+			accumulator = _mm_add_epi32(accumulator, result);
+		}
+
+		accumulator = _mm_hadd_epi32(accumulator, accumulator);
+		accumulator = _mm_hadd_epi32(accumulator, accumulator);
+
+		output[0] = (_mm_cvtsi128_si32(accumulator) + bias[0]) >> log_scaling_weights;
+	}
+	else {
+		// Calculate 4 outputs at a time, as in the AVX2 version
+		for (int i = 0; i < num_outputs; i += 4) {
+
+			const int8_t* const weights_0 = weights + (i + 0) * num_inputs;
+			const int8_t* const weights_1 = weights + (i + 1) * num_inputs;
+			const int8_t* const weights_2 = weights + (i + 2) * num_inputs;
+			const int8_t* const weights_3 = weights + (i + 3) * num_inputs;
+
+			__m128i accumulator_0 = _mm_setzero_si128();
+			__m128i accumulator_1 = _mm_setzero_si128();
+			__m128i accumulator_2 = _mm_setzero_si128();
+			__m128i accumulator_3 = _mm_setzero_si128();
+
+			for (int j = 0; j < num_inputs; j += 16) {
+				const __m128i inp = _mm_load_si128((__m128i*) &input[j]);
+
+				const __m128i result_0 = _mm_madd_epi16(_mm_maddubs_epi16(inp, _mm_load_si128((__m128i*) &weights_0[j])), ones);
+				const __m128i result_1 = _mm_madd_epi16(_mm_maddubs_epi16(inp, _mm_load_si128((__m128i*) &weights_1[j])), ones);
+				const __m128i result_2 = _mm_madd_epi16(_mm_maddubs_epi16(inp, _mm_load_si128((__m128i*) &weights_2[j])), ones);
+				const __m128i result_3 = _mm_madd_epi16(_mm_maddubs_epi16(inp, _mm_load_si128((__m128i*) &weights_3[j])), ones);
+
+				accumulator_0 = _mm_add_epi32(result_0, accumulator_0);
+				accumulator_1 = _mm_add_epi32(result_1, accumulator_1);
+				accumulator_2 = _mm_add_epi32(result_2, accumulator_2);
+				accumulator_3 = _mm_add_epi32(result_3, accumulator_3);
+			}
+
+			// (acc0, acc0, acc1, acc1), (acc2, acc2, acc3, acc3) -> (acc0, acc1, acc2, acc3)
+			const __m128i tmp_1 = _mm_hadd_epi32(accumulator_0, accumulator_1);
+			const __m128i tmp_2 = _mm_hadd_epi32(accumulator_2, accumulator_3);
+			__m128i result = _mm_hadd_epi32(tmp_1, tmp_2);
+
+			// Add bias to all 4 outputs and divide by scaling factor
+			result = _mm_add_epi32(result, _mm_load_si128((__m128i*) &bias[i]));
+			result = _mm_srai_epi32(result, log_scaling_weights);
+
+			_mm_store_si128((__m128i*) &output[i], result);
+		}
+	}
+}
+
+void updateAccumulatorSSE41(const int16_t* input, int16_t* output, const int16_t* const* added, int num_added,
+							const int16_t* const* removed, int num_removed, int size) {
+	for (int i = 0; i < size; i += 8) {
+		__m128i acc = _mm_load_si128((__m128i*) &input[i]);
+
+		for (int j = 0; j < num_added; j++)
+			acc = _mm_add_epi16(acc, _mm_load_si128((__m128i*) &added[j][i]));
+
+		for (int j = 0; j < num_removed; j++)
+			acc = _mm_sub_epi16(acc, _mm_load_si128((__m128i*) &removed[j][i]));
+
+		_mm_store_si128((__m128i*) &output[i], acc);
+	}
+}
@@ -0,0 +1,39 @@
+#include "Kernels.h"
+#include "LinearLayer.h"
+#include <algorithm>
+#include <cstdint>
+
+void creluScalar(const int16_t* input, int8_t* output, int size) {
+	for (int i = 0; i < size; i++)
+		output[i] = static_cast<int8_t>(std::clamp<int16_t>(input[i], 0, 127));
+}
+
+void creluScalar(const int32_t* input, int8_t* output, int size) {
+	for (int i = 0; i < size; i++)
+		output[i] = static_cast<int8_t>(std::clamp<int32_t>(input[i], 0, 127));
+}
+
+void processLinearLayerScalar(const int8_t* input, int32_t* output, const int8_t* weights, const int32_t* bias, int num_inputs, int num_outputs) {
+	for (int i = 0; i < num_outputs; i++) {
+		const int8_t* weights_i = weights + i * num_inputs;
+
+		// Input is always positive because of the activation function
+		int32_t sum = 0;
+		for (int j = 0; j < num_inputs; j++)
+			sum += static_cast<uint8_t>(input[j]) * weights_i[j];
+
+		output[i] = (sum + bias[i]) >> log_scaling_weights;
+	}
+}
+
+void updateAccumulatorScalar(const int16_t* input, int16_t* output, const int16_t* const* added, int num_added,
+							 const int16_t* const* removed, int num_removed, int size) {
+	for (int i = 0; i < size; i++) {
+		int16_t acc = input[i];
+
+		for (int j = 0; j < num_added; j++)	  acc += added[j][i];
+		for (int j = 0; j < num_removed; j++) acc -= removed[j][i];
+
+		output[i] = acc;
+	}
+}
@@ -1,18 +1,31 @@
 #pragma once
+#include <bit>
 #include <cstdint>
-#include <filesystem>
 
+struct NNUEKernels;
+
+constexpr uint32_t scaling_weights = 64; // same as in Train/train.py
+static_assert((scaling_weights & (scaling_weights - 1)) == 0, "scaling_weights must be a power of two.");
+
+constexpr int log_scaling_weights = std::countr_zero(scaling_weights); // log2(scaling_weights)
+
+// Weights are inside the mapped network file, shared (read only) by the NNUE of every search thread
 struct LinearLayer {
 private:
-	int32_t*	bias;
-	int8_t*		weights;
-	int			num_inputs, num_outputs;
+	const int32_t*	bias = nullptr;
+	const int8_t*	weights = nullptr;
+	int				num_inputs, num_outputs;
 
 public:
 	LinearLayer(int num_inputs, int num_outputs);
-	~LinearLayer();
 	
-	void processLinearLayer(int8_t* const input, int32_t* output) const;
+	void processLinearLayer(const NNUEKernels& kernels, int8_t* const input, int32_t* output) const;
+
+	inline void setWeights(const int32_t* bias, const int8_t* weights) {
+		this->bias = bias;
+		this->weights = weights;
+	}
 
-	bool setWeights(std::filesystem::path file_biases, std::filesystem::path file_weights);
+	inline int getNumInputs() const { return num_inputs; }
+	inline int getNumOutputs() const { return num_outputs; }
 };
@@ -0,0 +1,94 @@
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+#ifdef _WIN32
+bool MappedFile::open(const std::filesystem::path& path) {
+	close();
+
+	HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr) {
+		CloseHandle(file);
+		return false;
+	}
+
+	const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	if (view == nullptr) {
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return false;
+	}
+
+	file_handle = file;
+	mapping_handle = mapping;
+	mapped_data = static_cast<const uint8_t*>(view);
+	mapped_size = (size_t) file_size.QuadPart;
+
+	return true;
+}
+
+void MappedFile::close() {
+	if (mapped_data != nullptr) UnmapViewOfFile(mapped_data);
+	if (mapping_handle != nullptr) CloseHandle(mapping_handle);
+	if (file_handle != nullptr) CloseHandle(file_handle);
+
+	mapped_data = nullptr;
+	mapped_size = 0;
+	file_handle = mapping_handle = nullptr;
+}
+#else
+bool MappedFile::open(const std::filesystem::path& path) {
+	close();
+
+	int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd == -1) return false;
+
+	struct stat file_stat;
+	if (fstat(fd, &file_stat) == -1 || file_stat.st_size == 0) {
+		::close(fd);
+		return false;
+	}
+
+	// The mapping stays valid after the file descriptor is closed
+	void* view = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (view == MAP_FAILED) return false;
+
+	mapped_data = static_cast<const uint8_t*>(view);
+	mapped_size = (size_t) file_stat.st_size;
+
+	return true;
+}
+
+void MappedFile::close() {
+	if (mapped_data != nullptr) munmap((void*) mapped_data, mapped_size);
+
+	mapped_data = nullptr;
+	mapped_size = 0;
+}
+#endif
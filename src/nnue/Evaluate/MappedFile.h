@@ -0,0 +1,29 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+// Read only memory mapping of a whole file, its pages are shared by every process that maps the same file
+class MappedFile {
+	const uint8_t*	mapped_data = nullptr;
+	size_t			mapped_size = 0;
+#ifdef _WIN32
+	void*			file_handle = nullptr;
+	void*			mapping_handle = nullptr;
+#endif
+
+public:
+	MappedFile() = default;
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	// Maps the file, unmapping the previous one, returns false if the file could not be mapped
+	bool open(const std::filesystem::path& path);
+	void close();
+
+	inline const uint8_t* data() const { return mapped_data; }
+	inline size_t size() const { return mapped_size; }
+	inline bool isOpen() const { return mapped_data != nullptr; }
+};
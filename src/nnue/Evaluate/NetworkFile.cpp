@@ -0,0 +1,51 @@
+#include "NetworkFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+uint64_t networkChecksum(const uint8_t* data, size_t size) {
+	uint64_t hash = 0xcbf29ce484222325;
+
+	for (size_t i = 0; i < size; i += 8) {
+		uint64_t word;
+		std::memcpy(&word, data + i, sizeof(word));
+
+		hash ^= word;
+		hash *= 0x100000001b3;
+	}
+
+	return hash;
+}
+
+// Section with the expected size, aligned and inside the file (after the header)
+static bool isValidSection(const NetworkSection& section, uint64_t expected_size, size_t file_size) {
+	if (section.size != expected_size || section.offset % network_section_alignment != 0) return false;
+	return section.offset >= sizeof(NetworkFileHeader) && section.offset <= file_size && section.size <= file_size - section.offset;
+}
+
+const NetworkFileHeader* validateNetworkFile(const uint8_t* data, size_t size, const LayerShape (&expected_layers)[num_network_layers]) {
+	if (data == nullptr || size < sizeof(NetworkFileHeader)) return nullptr;
+
+	const NetworkFileHeader* header = reinterpret_cast<const NetworkFileHeader*>(data);
+
+	if (std::memcmp(header->magic, network_file_magic, sizeof(network_file_magic)) != 0) return nullptr;
+	if (header->version != network_file_version || header->header_size != sizeof(NetworkFileHeader)) return nullptr;
+	if (header->num_layers != num_network_layers) return nullptr;
+
+	for (int i = 0; i < num_network_layers; i++) {
+		const LayerShape& layer = header->layers[i];
+		if (layer.num_inputs != expected_layers[i].num_inputs || layer.num_outputs != expected_layers[i].num_outputs) return nullptr;
+
+		// Accumulator has i16 biases and weights, linear layers i32 biases and i8 weights
+		uint64_t size_bias    = (uint64_t) layer.num_outputs * ((i == 0) ? sizeof(int16_t) : sizeof(int32_t));
+		uint64_t size_weights = (uint64_t) layer.num_outputs * layer.num_inputs * ((i == 0) ? sizeof(int16_t) : sizeof(int8_t));
+
+		if (!isValidSection(header->sections[2 * i], size_bias, size))			return nullptr;
+		if (!isValidSection(header->sections[2 * i + 1], size_weights, size))	return nullptr;
+	}
+
+	if ((size - sizeof(NetworkFileHeader)) % 8 != 0) return nullptr;
+	if (networkChecksum(data + sizeof(NetworkFileHeader), size - sizeof(NetworkFileHeader)) != header->checksum) return nullptr;
+
+	return header;
+}
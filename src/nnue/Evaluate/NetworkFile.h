@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/*
+	Single file with all the weights of the network, written by Train/network_file.py. Little endian, a header followed by
+	one section for the biases and one for the weights of each layer (in this order, starting from the accumulator), each
+	section starts at an offset that is a multiple of 64, so the weights can be used directly from a memory mapping of the
+	file. Accumulator has i16 biases and weights, the linear layers have i32 biases and i8 weights, weights of the
+	accumulator are stored by input and weights of the linear layers by output.
+*/
+constexpr char network_file_magic[8] = { 'C', 'E', 'N', 'N', 'U', 'E', '\0', '\0' };
+constexpr uint32_t network_file_version = 1;
+constexpr size_t network_section_alignment = 64;
+constexpr int num_network_layers = 4; // Accumulator and 3 linear layers
+
+struct LayerShape {
+	uint32_t num_inputs;
+	uint32_t num_outputs;
+};
+
+struct NetworkSection {
+	uint64_t offset; // From the start of the file
+	uint64_t size;	 // In bytes
+};
+
+struct NetworkFileHeader {
+	char			magic[8];
+	uint32_t		version;
+	uint32_t		header_size;
+	uint64_t		checksum;	// networkChecksum of the file after the header
+	uint32_t		num_layers;
+	uint32_t		reserved;
+	LayerShape		layers[num_network_layers];
+	NetworkSection	sections[2 * num_network_layers]; // Biases and weights of each layer
+};
+static_assert(sizeof(NetworkFileHeader) % network_section_alignment == 0, "Header must keep the sections aligned.");
+
+// FNV-1a of the little endian 64 bit words of data, size must be a multiple of 8
+uint64_t networkChecksum(const uint8_t* data, size_t size);
+
+/*
+	Returns the header of the network file if it is valid: same magic and version, layers with the expected shapes,
+	aligned sections of the expected sizes inside the file and a matching checksum. Returns nullptr otherwise.
+*/
+const NetworkFileHeader* validateNetworkFile(const uint8_t* data, size_t size, const LayerShape (&expected_layers)[num_network_layers]);
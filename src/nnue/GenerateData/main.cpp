@@ -29,12 +29,7 @@ constexpr int Max_Eval = 1000;
 // Take csv file (FEN, eval) and convert to locations inputs 1.
 int main() {
 
-	bool loaded = magic_bitboards.loadMagicBitboards();
-	if (!loaded) {
-		std::cout << "Couldn't load Magic Bitboards file.";
-		return 9;
-	}
-
+	NNUE nnue;
 	if (calculate_loss) {
 		if (!nnue.is_loaded()) {
 			std::cout << "Couldn't load weights of NNUE.";
@@ -110,7 +105,7 @@ int main() {
 
 			// Compute loss nnue
 			nnue.setPosition(position.player1, position.player2);
-			ev = nnue.evaluate();
+			ev = nnue.evaluate(position.player1, position.player2);
 			if (abs(ev) > Max_Eval) ev = Max_Eval * ((ev < 0) ? -1 : 1);
 			error_nnue += loss(ev, evaluation);
 
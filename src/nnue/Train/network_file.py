@@ -0,0 +1,70 @@
+import numpy as np
+import struct
+import sys
+
+# Single network file read by the engine, layout described in Evaluate/NetworkFile.h
+NETWORK_FILE_MAGIC = b"CENNUE\0\0"
+NETWORK_FILE_VERSION = 1
+SECTION_ALIGNMENT = 64
+HEADER_SIZE = 192
+
+NUM_INPUTS_ACC = 64 * 64 * 10
+LAYER_SHAPES = [(NUM_INPUTS_ACC, 256), (512, 32), (32, 32), (32, 1)] # (inputs, outputs) of each layer
+SECTION_TYPES = [np.int16, np.int16, np.int32, np.int8, np.int32, np.int8, np.int32, np.int8] # Biases and weights of each layer
+
+FNV_OFFSET = 0xcbf29ce484222325
+FNV_PRIME = 0x100000001b3
+MASK_64 = (1 << 64) - 1
+
+
+def checksum(data):
+    """FNV-1a of the little endian 64 bit words of data (same as networkChecksum)"""
+    h = FNV_OFFSET
+    for word in np.frombuffer(data, dtype="<u8").tolist():
+        h = ((h ^ word) * FNV_PRIME) & MASK_64
+    return h
+
+
+def write_network(path, sections):
+    """
+    sections: biases and weights of each layer, in order starting from the accumulator. Weights of the accumulator
+    are stored by input (inputs x outputs) and weights of the linear layers by output (outputs x inputs).
+    """
+    assert len(sections) == len(SECTION_TYPES)
+
+    body = bytearray()
+    offsets = []
+    for i, (section, dtype) in enumerate(zip(sections, SECTION_TYPES)):
+        inputs, outputs = LAYER_SHAPES[i // 2]
+        expected_size = outputs if i % 2 == 0 else inputs * outputs
+        section = np.ascontiguousarray(section, dtype=np.dtype(dtype).newbyteorder("<")).reshape(-1)
+        assert section.size == expected_size, f"Section {i} has {section.size} elements, expected {expected_size}"
+
+        body += bytes(-(HEADER_SIZE + len(body)) % SECTION_ALIGNMENT)
+        offsets.append((HEADER_SIZE + len(body), section.nbytes))
+        body += section.tobytes()
+
+    body += bytes(-len(body) % SECTION_ALIGNMENT)
+
+    header = NETWORK_FILE_MAGIC
+    header += struct.pack("<IIQII", NETWORK_FILE_VERSION, HEADER_SIZE, checksum(body), len(LAYER_SHAPES), 0)
+    header += b"".join(struct.pack("<II", *shape) for shape in LAYER_SHAPES)
+    header += b"".join(struct.pack("<QQ", *offset) for offset in offsets)
+    assert len(header) == HEADER_SIZE
+
+    with open(path, "wb") as f:
+        f.write(header)
+        f.write(body)
+
+
+def main():
+    """Packs the separate .bin files of the weights (old format) in a single network file"""
+    weights_dir = sys.argv[1] if len(sys.argv) > 1 else "../Weights"
+    names = ["accb", "accw", "lin1b", "lin1w", "lin2b", "lin2w", "lin3b", "lin3w"]
+
+    sections = [np.fromfile(f"{weights_dir}/{name}.bin", dtype=dtype) for name, dtype in zip(names, SECTION_TYPES)]
+    write_network(f"{weights_dir}/nnue.bin", sections)
+
+
+if __name__ == "__main__":
+    main()
@@ -1,5 +1,6 @@
 import tensorflow as tf
 from train import *
+from network_file import write_network
 
 def main():
 
@@ -14,21 +15,17 @@ def main():
     vec_weights_out = np.vectorize(lambda x: np.round((SCALING_QUANT_WEIGHTS * SCALING_QUANT_OUTPUT) / SCALING_QUANT_ACC * x), otypes=[np.int8])
     vec_biases_out  = np.vectorize(lambda x: np.round(SCALING_QUANT_WEIGHTS * SCALING_QUANT_OUTPUT * x), otypes=[np.int32])
 
-    # First dense layer (accumulator)
-    vec_acc(loaded_model.layers[2].get_weights()[0]).tofile("../Weights/accw.bin") # Weights
-    vec_acc(loaded_model.layers[2].get_weights()[1]).tofile("../Weights/accb.bin") # Biases
-
-    # Second dense layer (first linear layer)
-    vec_weights_lin(loaded_model.layers[5].get_weights()[0]).transpose().tofile("../Weights/lin1w.bin")
-    vec_biases_lin(loaded_model.layers[5].get_weights()[1]).tofile("../Weights/lin1b.bin")
-
-    # Third dense layer (second linear layer)
-    vec_weights_lin(loaded_model.layers[7].get_weights()[0]).transpose().tofile("../Weights/lin2w.bin")
-    vec_biases_lin(loaded_model.layers[7].get_weights()[1]).tofile("../Weights/lin2b.bin")
-
-    # Fourth dense layer (third linear layer)
-    vec_weights_out(loaded_model.layers[8].get_weights()[0]).transpose().tofile("../Weights/lin3w.bin") # Weights
-    vec_biases_out(loaded_model.layers[8].get_weights()[1]).tofile("../Weights/lin3b.bin") # Biases
+    layers = loaded_model.layers
+    write_network("../Weights/nnue.bin", [
+        vec_acc(layers[2].get_weights()[1]),                         # Accumulator biases
+        vec_acc(layers[2].get_weights()[0]),                         # Accumulator weights
+        vec_biases_lin(layers[5].get_weights()[1]),                  # First linear layer
+        vec_weights_lin(layers[5].get_weights()[0]).transpose(),
+        vec_biases_lin(layers[7].get_weights()[1]),                  # Second linear layer
+        vec_weights_lin(layers[7].get_weights()[0]).transpose(),
+        vec_biases_out(layers[8].get_weights()[1]),                  # Third linear layer (output)
+        vec_weights_out(layers[8].get_weights()[0]).transpose(),
+    ])
 
 
 if __name__ == "__main__":
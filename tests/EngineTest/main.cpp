@@ -7,6 +7,7 @@
 #include "Player.h"
 #include "Position.h"
 #include "Search.h"
+#include "SearchContext.h"
 #include "TranspositionTable.h"
 #include "Zobrist.h"
 #include "EvaluateNNUE.h"
@@ -17,20 +18,13 @@
 
 using std::cout, std::cin;
 
-constexpr int size_TT = 256; // Size in mb, must be a power of two
+constexpr int size_TT = 256; // Size in mb
 
 void time_engine(Position& initial_pos, const MagicBitboards& magic_bitboards, const ZobristKeys& zobrist_keys);
 
 int main() {
 
-	// Load Magic Bitboards
-	bool loaded = magic_bitboards.loadMagicBitboards();
-	if (!loaded) {
-		cout << "Couldn't load Magic Bitboards file.";
-		return 9;
-	}
-
-	if (!nnue.is_loaded()) {
+	if (!network_weights.loaded) {
 		cout << "Couldn't load weights of NNUE.";
 		return 10;
 	}
@@ -56,13 +50,13 @@ void time_engine(Position& initial_pos, const MagicBitboards& magic_bitboards, c
 
 	unsigned long long hash = zobrist_keys.positionToHash(initial_pos.player1, initial_pos.player2);
 	HashPositions positions(hash);
-	tt = TranspositionTable(size_TT);
+	TranspositionTable tt(size_TT);
 	tt.setRoot(initial_pos.player1.bitboards.all_pieces);
 
-	nnue.setPosition(initial_pos.player1, initial_pos.player2);
+	SearchContext context(tt);
 
 	auto start = std::chrono::high_resolution_clock::now();
-	FindBestMoveItrDeepening(search_depth, initial_pos.player1, initial_pos.player2, positions, initial_pos.half_moves);
+	FindBestMoveItrDeepening(context, search_depth, initial_pos.player1, initial_pos.player2, positions, initial_pos.half_moves);
 	auto stop = std::chrono::high_resolution_clock::now();
 	auto duration = duration_cast<std::chrono::milliseconds>(stop - start);
 
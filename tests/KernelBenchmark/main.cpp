@@ -0,0 +1,138 @@
+#include "CpuFeatures.h"
+#include "Kernels.h"
+#include "OrderingKernels.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Compares the versions of the SIMD kernels supported by the CPU, on random inputs with the sizes used by the engine
+
+struct OrderingVersion {
+	const char* name;
+	BestMoveIndexFn fn;
+	bool supported;
+};
+
+// Runs f iterations times and returns the average time of a call in nanoseconds
+template <typename F>
+double timeNs(int iterations, F f) {
+	auto start = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < iterations; i++) f();
+	auto stop = std::chrono::high_resolution_clock::now();
+
+	return std::chrono::duration<double, std::nano>(stop - start).count() / iterations;
+}
+
+void printResult(const std::string& kernel, const char* version, double ns, bool matches) {
+	std::cout << kernel << " " << version << ": " << ns << " ns" << (matches ? "" : " (different result than first version)") << '\n';
+}
+
+int main() {
+	const CpuFeatures& cpu = cpuFeatures();
+	std::mt19937 rng(0);
+	volatile int sink = 0; // Prevents calls from being optimized away
+	constexpr int iterations = 1'000'000;
+
+	std::vector<OrderingVersion> ordering_versions = {
+#ifdef PORTABLE_KERNELS
+		{ "scalar", bestMoveIndexScalar, true },
+		{ "SSE4.1", bestMoveIndexSSE41, cpu.sse41 },
+#endif
+		{ "AVX2", bestMoveIndexAVX2, cpu.avx2 },
+	};
+
+	std::vector<const NNUEKernels*> nnue_versions = {
+#ifdef PORTABLE_KERNELS
+		&scalar_kernels,
+#endif
+	};
+#ifdef PORTABLE_KERNELS
+	if (cpu.sse41)		nnue_versions.push_back(&sse41_kernels);
+#endif
+	if (cpu.avx2)		nnue_versions.push_back(&avx2_kernels);
+	if (cpu.avx512bw)	nnue_versions.push_back(&avx512bw_kernels);
+	if (cpu.avx512vnni) nnue_versions.push_back(&avx512vnni_kernels);
+
+	std::cout << "Selected NNUE kernels: " << selectNNUEKernels().name << "\n\n";
+
+	// Scores as set by orderMoves, the low 3 bits encode the block of 16 moves
+	alignas(64) unsigned short scores[256] = {};
+	for (int num_moves : { 16, 40, 100, 218 }) {
+		for (int i = 0; i < num_moves; i++)
+			scores[i] = ((rng() % 4000) << 3) + 7 - (i / 16);
+
+		int expected = -1;
+		for (const OrderingVersion& version : ordering_versions) {
+			if (!version.supported) continue;
+
+			int idx = version.fn(scores, num_moves);
+			if (expected == -1) expected = idx;
+
+			double ns = timeNs(iterations, [&]() { sink = version.fn(scores, num_moves); });
+			printResult("bestMoveIndex (" + std::to_string(num_moves) + " moves)", version.name, ns, idx == expected);
+		}
+	}
+	std::cout << '\n';
+
+	alignas(64) int16_t accumulator[512];
+	alignas(64) int32_t hidden[32];
+	alignas(64) int8_t input[512], output[512], weights[512 * 32];
+	alignas(64) int32_t bias[32], output_32[32];
+	alignas(64) int16_t features[4][256], accumulator_out[256];
+
+	for (int16_t& x : accumulator) x = (int16_t) (rng() % 512) - 256;
+	for (int32_t& x : hidden) x = (int32_t) (rng() % 512) - 256;
+	for (int8_t& x : input) x = rng() % 128;
+	for (int8_t& x : weights) x = (int8_t) (rng() % 256 - 128);
+	for (int32_t& x : bias) x = (int32_t) (rng() % 4096) - 2048;
+	for (auto& feature : features)
+		for (int16_t& x : feature) x = (int16_t) (rng() % 256) - 128;
+
+	const int16_t* added[2] = { features[0], features[1] };
+	const int16_t* removed[2] = { features[2], features[3] };
+
+	// Checksum of the outputs, compared against the first version
+	auto checksum = [](const auto* arr, int size) {
+		long long sum = 0;
+		for (int i = 0; i < size; i++) sum = sum * 31 + arr[i];
+		return sum;
+	};
+
+	long long expected[5] = {};
+	for (int v = 0; v < (int) nnue_versions.size(); v++) {
+		const NNUEKernels& k = *nnue_versions[v];
+		long long results[5];
+
+		k.crelu_16(accumulator, output, 512);
+		results[0] = checksum(output, 512);
+		k.crelu_32(hidden, output, 32);
+		results[1] = checksum(output, 32);
+		k.linear_layer(input, output_32, weights, bias, 512, 32);
+		results[2] = checksum(output_32, 32);
+		k.linear_layer(input, output_32, weights, bias, 32, 32);
+		results[3] = checksum(output_32, 32);
+		k.update_accumulator(accumulator, accumulator_out, added, 2, removed, 2, 256);
+		results[4] = checksum(accumulator_out, 256);
+
+		if (v == 0) std::copy(results, results + 5, expected);
+
+		double ns;
+		ns = timeNs(iterations, [&]() { k.crelu_16(accumulator, output, 512); sink = output[0]; });
+		printResult("crelu (512 x i16)", k.name, ns, results[0] == expected[0]);
+		ns = timeNs(iterations, [&]() { k.crelu_32(hidden, output, 32); sink = output[0]; });
+		printResult("crelu (32 x i32)", k.name, ns, results[1] == expected[1]);
+		ns = timeNs(iterations, [&]() { k.linear_layer(input, output_32, weights, bias, 512, 32); sink = output_32[0]; });
+		printResult("linear layer (512 -> 32)", k.name, ns, results[2] == expected[2]);
+		ns = timeNs(iterations, [&]() { k.linear_layer(input, output_32, weights, bias, 32, 32); sink = output_32[0]; });
+		printResult("linear layer (32 -> 32)", k.name, ns, results[3] == expected[3]);
+		ns = timeNs(iterations, [&]() { k.update_accumulator(accumulator, accumulator_out, added, 2, removed, 2, 256); sink = accumulator_out[0]; });
+		printResult("update accumulator (256, 2 added, 2 removed)", k.name, ns, results[4] == expected[4]);
+		std::cout << '\n';
+	}
+
+	return 0;
+}
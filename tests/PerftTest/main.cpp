@@ -1,17 +1,29 @@
 ﻿#include "Perft.h"
 #include "Position.h"
 #include "Engine.h"
+#include <algorithm>
 #include <array>
 #include <chrono>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <vector>
 #include <sstream>
+#include <thread>
 #include <tuple>
 
-int main() {
+/*
+	Number of threads can be passed as the first argument, all hardware threads are used by default.
+	Size in MB of the perft hash table can be passed as the second argument, no table is used by default so that
+	every position is generated (as needed to measure the speed of move generation).
+*/
+int main(int argc, char* argv[]) {
 	int start_depth = 1;
 	int max_depth = 6;
+	int num_threads = (argc > 1) ? std::atoi(argv[1]) : (int) std::thread::hardware_concurrency();
+	if (num_threads < 1) num_threads = 1;
+	int hash_size_mb = (argc > 2) ? std::atoi(argv[2]) : 0;
 	bool test_passed = true;
 	std::chrono::milliseconds total_duration(0);
 	unsigned long long total_positions = 0;
@@ -32,6 +44,11 @@ int main() {
 	in_file.open(dir_path + "\\perftsuite.epd");
 	if (!in_file.is_open()) return -2;
 
+	std::unique_ptr<PerftTable> table;
+	if (hash_size_mb > 0) table = std::make_unique<PerftTable>(hash_size_mb);
+
+	std::cout << "Threads: " << num_threads << ". Hash: " << hash_size_mb << " MB\n";
+
 	std::string line;
 	while (std::getline(in_file, line)) {
 		std::stringstream perft_str(line);
@@ -51,7 +68,7 @@ int main() {
 			unsigned long long expected_num_nodes = std::stoull(perft[depth].substr(3));
 
 			auto start = std::chrono::high_resolution_clock::now();
-			unsigned long long num_nodes = Perft(depth, player, opponent);
+			unsigned long long num_nodes = Perft(depth, player, opponent, num_threads, table.get());
 			auto stop = std::chrono::high_resolution_clock::now();
 
 			if (expected_num_nodes == num_nodes) {
@@ -71,5 +88,6 @@ int main() {
 
 	std::cout << '\n' << (test_passed ? "Test Suite Passed." : "Test Suite Failed.") 
 			  << " Total positions searched: " << total_positions 
-			  << ". Total Time: " << total_duration.count() << " ms.\n";
+			  << ". Total Time: " << total_duration.count() << " ms. Nodes per second: "
+			  << total_positions * 1000 / std::max<long long>(total_duration.count(), 1) << ".\n";
 }
@@ -24,9 +24,6 @@ namespace UnitTest
 		
 		TEST_METHOD(FenToMemoryTest) // Test conversion from FEN to position in memory
 		{
-			bool loaded = magic_bitboards.loadMagicBitboards();
-			Assert::IsTrue(loaded);
-
 			auto [pl, op, half_moves, full_moves] = FENToPosition("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
 
 			// 0 is white, 1 is black